@@ -14,6 +14,21 @@ Base::Base() {
 
 }
 
+COMMAND_ID Base::onReceive(const FrameView &body){
+	std::vector<uint8_t> frameBody(body.size());
+	body.copy(0, frameBody.data(), frameBody.size());
+	return onReceive(frameBody);
+}
+
+uint8_t Base::transmit(uint8_t* body, uint8_t capacity){
+	const std::vector<uint8_t> res = transmit();
+	if(res.size() > capacity){
+		return 0;
+	}
+	copy(res.data(), body, res.size());
+	return res.size();
+}
+
 void Base::copy(const void* src, const void* dest, const uint8_t len){
 	std::copy((uint8_t*)src, (uint8_t*)src+len, (uint8_t*)dest);
 }
@@ -0,0 +1,283 @@
+/*
+ * FlightRecorder.cpp
+ *
+ *  Created on: Mar 11, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#include "./Inc/FlightRecorder.hpp"
+
+#if defined(__linux__)
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace command{
+	namespace {
+		int64_t realtimeNs(){
+			timespec now;
+			clock_gettime(CLOCK_REALTIME, &now);
+			return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+		}
+	}
+
+	FlightRecorder::FlightRecorder():clock(&realtimeNs){
+	}
+
+	FlightRecorder::~FlightRecorder(){
+		close();
+	}
+
+	bool FlightRecorder::open(const char* path, size_t windowSize){
+		close();
+		if(windowSize == 0 || windowSize % WINDOW_ALIGN != 0){
+			return false;
+		}
+		fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if(fd < 0){
+			return false;
+		}
+		this->windowSize = windowSize;
+		blockOffset = 0;
+		used = 0;
+		sequence = 0;
+		frameCount = 0;
+		droppedCount = 0;
+		stallCount = 0;
+		map = mapWindow(0);
+		if(map == nullptr){
+			::close(fd);
+			fd = -1;
+			return false;
+		}
+		windowOffset = 0;
+		stopping = false;
+		wanted = windowSize;
+		preparer = std::thread([this](){ prepareWindows(); });
+
+		flightlog::FileHeader header = {};
+		header.version = flightlog::VERSION;
+		header.blockSize = flightlog::BLOCK_SIZE;
+		header.createdTime = clock();
+		header.idCount = static_cast<uint8_t>(COMMAND_ID::Last);
+		std::memcpy(map, &header, sizeof(header));
+		__atomic_store_n(reinterpret_cast<uint64_t*>(map), flightlog::FILE_MAGIC, __ATOMIC_RELEASE);
+		return true;
+	}
+
+	bool FlightRecorder::close(){
+		if(fd < 0){
+			return false;
+		}
+		if(preparer.joinable()){
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stopping = true;
+			}
+			wake.notify_one();
+			preparer.join();
+		}
+		for(uint8_t* window : {map, prepared, retired}){
+			if(window != nullptr){
+				munmap(window, windowSize);
+			}
+		}
+		map = nullptr;
+		prepared = nullptr;
+		retired = nullptr;
+		wanted = NO_WINDOW;
+		//the log is also readable with the reserved tail when this fails
+		const bool trimmed = ftruncate(fd, blockOffset + flightlog::BLOCK_SIZE) == 0;
+		::close(fd);
+		fd = -1;
+		return trimmed;
+	}
+
+	bool FlightRecorder::record(COMMAND_ID id, const FrameView &body, int64_t time){
+		const size_t len = flightlog::RECORD_HEADER_SIZE + body.size();
+		if(map == nullptr || body.size() > 0xff){
+			droppedCount++;
+			return false;
+		}
+		if(blockOffset == 0 || used + len > flightlog::BLOCK_PAYLOAD){
+			if(!startBlock(time)){
+				droppedCount++;
+				return false;
+			}
+		}
+
+		uint8_t* block = map + (blockOffset - windowOffset);
+		uint8_t* out = block + sizeof(flightlog::BlockHeader) + used;
+		std::memcpy(out, &time, sizeof(time));
+		out[8] = static_cast<uint8_t>(id);
+		out[9] = static_cast<uint8_t>(body.size());
+		body.copy(0, out + flightlog::RECORD_HEADER_SIZE, body.size());
+		used += len;
+		//publish the record only after its bytes
+		__atomic_store_n(&reinterpret_cast<flightlog::BlockHeader*>(block)->committed, static_cast<uint32_t>(used), __ATOMIC_RELEASE);
+		frameCount++;
+		return true;
+	}
+
+	bool FlightRecorder::flush(){
+		return map != nullptr && msync(map, windowSize, MS_SYNC) == 0;
+	}
+
+	bool FlightRecorder::startBlock(int64_t time){
+		const size_t next = blockOffset == 0 ? flightlog::BLOCK_SIZE : blockOffset + flightlog::BLOCK_SIZE;
+		if(next + flightlog::BLOCK_SIZE > windowOffset + windowSize && !switchWindow(next - next % windowSize)){
+			return false;
+		}
+		blockOffset = next;
+		used = 0;
+
+		flightlog::BlockHeader* header = reinterpret_cast<flightlog::BlockHeader*>(map + (blockOffset - windowOffset));
+		header->committed = 0;
+		header->firstIndex = frameCount;
+		header->firstTime = time;
+		header->sequence = sequence++;
+		header->reserved = 0;
+		__atomic_store_n(&header->magic, flightlog::BLOCK_MAGIC, __ATOMIC_RELEASE);
+		return true;
+	}
+
+	bool FlightRecorder::nextWindowReady() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return prepared != nullptr && preparedOffset == windowOffset + windowSize;
+	}
+
+	/*
+	 * Switch to the window at offset, taking it from the helper when it is prepared.
+	 */
+	bool FlightRecorder::switchWindow(size_t offset){
+		uint8_t* window = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if(prepared != nullptr && preparedOffset == offset){
+				window = prepared;
+				prepared = nullptr;
+			}
+		}
+		if(window == nullptr){
+			//the helper fell behind or failed
+			stallCount++;
+			window = mapWindow(offset);
+			if(window == nullptr){
+				return false;
+			}
+		}
+		uint8_t* old = map;
+		map = window;
+		windowOffset = offset;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if(retired == nullptr){
+				retired = old;
+				old = nullptr;
+			}
+			wanted = offset + windowSize;
+		}
+		wake.notify_one();
+		if(old != nullptr){
+			munmap(old, windowSize);
+		}
+		return true;
+	}
+
+	/*
+	 * Reserve [offset, offset + windowSize) on disk, so writing through the map can not fail with SIGBUS
+	 * on a full disk, and map it with its pages populated, so the records written into it do not fault.
+	 * Returns nullptr on failure.
+	 */
+	uint8_t* FlightRecorder::mapWindow(size_t offset){
+		if(posix_fallocate(fd, offset, windowSize) != 0){
+			return nullptr;
+		}
+		void* window = mmap(nullptr, windowSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+		return window == MAP_FAILED ? nullptr : static_cast<uint8_t*>(window);
+	}
+
+	//the helper thread: unmap the windows left behind and prepare the wanted one, until close()
+	void FlightRecorder::prepareWindows(){
+		std::unique_lock<std::mutex> lock(mutex);
+		while(!stopping){
+			if(retired != nullptr){
+				uint8_t* old = retired;
+				retired = nullptr;
+				lock.unlock();
+				munmap(old, windowSize);
+				lock.lock();
+			}else if(wanted != NO_WINDOW){
+				const size_t offset = wanted;
+				wanted = NO_WINDOW;
+				lock.unlock();
+				uint8_t* window = mapWindow(offset);
+				lock.lock();
+				//one prepared too late, which record() mapped itself
+				if(prepared != nullptr){
+					munmap(prepared, windowSize);
+				}
+				prepared = window;
+				preparedOffset = offset;
+			}else{
+				wake.wait(lock);
+			}
+		}
+	}
+
+	bool FlightLogReader::open(const char* path){
+		close();
+		fd = ::open(path, O_RDONLY | O_CLOEXEC);
+		if(fd < 0){
+			return false;
+		}
+		const off_t size = lseek(fd, 0, SEEK_END);
+		if(size < static_cast<off_t>(flightlog::BLOCK_SIZE)){
+			close();
+			return false;
+		}
+		void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+		if(mapped == MAP_FAILED){
+			close();
+			return false;
+		}
+		map = static_cast<const uint8_t*>(mapped);
+		mapSize = size;
+		if(header().magic != flightlog::FILE_MAGIC || header().version != flightlog::VERSION ||
+		   header().blockSize != flightlog::BLOCK_SIZE){
+			close();
+			return false;
+		}
+		//blocks are started in order, so the started ones are a prefix: binary search for its end
+		size_t low = 0;
+		size_t high = mapSize / flightlog::BLOCK_SIZE - 1;
+		while(low < high){
+			const size_t mid = low + (high - low) / 2;
+			if(__atomic_load_n(&block(mid).magic, __ATOMIC_ACQUIRE) == flightlog::BLOCK_MAGIC && block(mid).sequence == mid){
+				low = mid + 1;
+			}else{
+				high = mid;
+			}
+		}
+		blocks = low;
+		madvise(const_cast<uint8_t*>(map), mapSize, MADV_SEQUENTIAL);
+		return true;
+	}
+
+	void FlightLogReader::close(){
+		if(map != nullptr){
+			munmap(const_cast<uint8_t*>(map), mapSize);
+			map = nullptr;
+		}
+		if(fd >= 0){
+			::close(fd);
+			fd = -1;
+		}
+		mapSize = 0;
+		blocks = 0;
+	}
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,130 @@
+/*
+ * FrameFanout.cpp
+ *
+ *  Created on: Mar 16, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#include "./Inc/FrameFanout.hpp"
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace command{
+	FrameFanout::FrameFanout(){
+		//the messages always point at the same slots; only the lengths change
+		for(size_t i = 0; i < BATCH; i++){
+			vectors[i].iov_base = slots[i].data();
+			vectors[i].iov_len = 0;
+			std::memset(&messages[i], 0, sizeof(messages[i]));
+			messages[i].msg_hdr.msg_iov = &vectors[i];
+			messages[i].msg_hdr.msg_iovlen = 1;
+		}
+	}
+
+	FrameFanout::~FrameFanout(){
+		for(size_t i = 0; i < MAX_SUBSCRIBERS; i++){
+			unsubscribe(i);
+		}
+	}
+
+	size_t FrameFanout::subscribeUdp(uint16_t port){
+		sockaddr_in address = {};
+		address.sin_family = AF_INET;
+		address.sin_port = htons(port);
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		return connectSocket(AF_INET, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+	}
+
+	size_t FrameFanout::subscribeUnix(const char* path){
+		sockaddr_un address = {};
+		address.sun_family = AF_UNIX;
+		if(std::strlen(path) >= sizeof(address.sun_path)){
+			return NO_SUBSCRIBER;
+		}
+		std::strcpy(address.sun_path, path);
+		return connectSocket(AF_UNIX, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+	}
+
+	void FrameFanout::unsubscribe(size_t subscriber){
+		if(subscriber < MAX_SUBSCRIBERS && subscribers[subscriber].fd >= 0){
+			::close(subscribers[subscriber].fd);
+			subscribers[subscriber] = Subscriber();
+		}
+	}
+
+	size_t FrameFanout::subscriberCount() const {
+		return std::count_if(subscribers.begin(), subscribers.end(), [](const Subscriber &s){ return s.fd >= 0; });
+	}
+
+	bool FrameFanout::publish(COMMAND_ID id, const FrameView &body){
+		if(1 + body.size() > MAX_DATAGRAM){
+			rejectedCount++;
+			return false;
+		}
+		uint8_t* slot = slots[queued].data();
+		slot[0] = static_cast<uint8_t>(id);
+		body.copy(0, slot + 1, body.size());
+		vectors[queued].iov_len = 1 + body.size();
+		queued++;
+		publishedCount++;
+		if(queued == BATCH){
+			flush();
+		}
+		return true;
+	}
+
+	size_t FrameFanout::flush(){
+		size_t sent = 0;
+		for(Subscriber &subscriber : subscribers){
+			if(subscriber.fd < 0){
+				continue;
+			}
+			size_t pos = 0;
+			while(pos < queued){
+				const int len = sendmmsg(subscriber.fd, messages.data() + pos, static_cast<unsigned int>(queued - pos), MSG_DONTWAIT | MSG_NOSIGNAL);
+				sendCount++;
+				if(len > 0){
+					pos += static_cast<size_t>(len);
+				}else if(len < 0 && errno == EINTR){
+					continue;
+				}else{
+					//full queue or gone; the subscriber misses the rest of this batch
+					subscriber.stats.dropped += queued - pos;
+					break;
+				}
+			}
+			subscriber.stats.sent += pos;
+			sent += pos;
+		}
+		queued = 0;
+		return sent;
+	}
+
+	size_t FrameFanout::connectSocket(int family, const sockaddr* address, socklen_t len){
+		auto unused = std::find_if(subscribers.begin(), subscribers.end(), [](const Subscriber &s){ return s.fd < 0; });
+		if(unused == subscribers.end()){
+			return NO_SUBSCRIBER;
+		}
+		const int fd = socket(family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		if(fd < 0){
+			return NO_SUBSCRIBER;
+		}
+		if(connect(fd, address, len) != 0){
+			::close(fd);
+			return NO_SUBSCRIBER;
+		}
+		unused->fd = fd;
+		unused->stats = SubscriberStatistics();
+		return static_cast<size_t>(unused - subscribers.begin());
+	}
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,83 @@
+/*
+ * Callback.hpp
+ *
+ *  Created on: Feb 18, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#ifndef COMMAND_INC_CALLBACK_HPP_
+#define COMMAND_INC_CALLBACK_HPP_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace command {
+
+/*
+ * Replacement of std::function for handler callbacks which never allocates.
+ * The callable is stored in place, so it must be trivially copyable and fit in Capacity bytes:
+ * function pointers and lambdas capturing a few references or pointers (e.g. [this], [&value]) are fine.
+ * Calling it is a single indirect call.
+ */
+template<typename Signature, size_t Capacity = 2 * sizeof(void*)>
+class Callback;
+
+template<typename R, typename... Args, size_t Capacity>
+class Callback<R(Args...), Capacity> {
+	using Invoker = R (*)(void*, Args...);
+
+	alignas(void*) mutable unsigned char storage[Capacity] = {};
+	Invoker invoker = &nop;
+
+	static R nop(void*, Args...){
+		return R();
+	}
+
+	template<typename F>
+	static R invoke(void* object, Args... args){
+		return (*static_cast<F*>(object))(std::forward<Args>(args)...);
+	}
+
+	template<typename T, auto Method>
+	static R invokeMethod(void* object, Args... args){
+		return ((*static_cast<T**>(object))->*Method)(std::forward<Args>(args)...);
+	}
+
+public:
+	Callback() = default;
+
+	template<typename F, typename = std::enable_if_t<
+		!std::is_same<std::decay_t<F>, Callback>::value && std::is_invocable_r<R, std::decay_t<F>&, Args...>::value>>
+	Callback(F &&function){
+		using Function = std::decay_t<F>;
+		static_assert(sizeof(Function) <= Capacity, "Callable is too large for Callback; capture by reference or bind a member function");
+		static_assert(alignof(Function) <= alignof(void*), "Callable is over-aligned for Callback");
+		static_assert(std::is_trivially_copyable<Function>::value && std::is_trivially_destructible<Function>::value,
+		              "Callback only stores trivially copyable callables; capture by reference instead of by value");
+		new (storage) Function(std::forward<F>(function));
+		invoker = &invoke<Function>;
+	}
+
+	/*
+	 * Bind a member function of object. Only the object pointer is stored.
+	 */
+	template<auto Method, typename T>
+	static Callback bind(T &object){
+		static_assert(sizeof(T*) <= Capacity, "Capacity can not hold an object pointer");
+		Callback res;
+		T* pointer = &object;
+		new (res.storage) T*(pointer);
+		res.invoker = &invokeMethod<T, Method>;
+		return res;
+	}
+
+	R operator()(Args... args) const {
+		return invoker(storage, std::forward<Args>(args)...);
+	}
+};
+
+} /* namespace command */
+
+#endif /* COMMAND_INC_CALLBACK_HPP_ */
@@ -10,7 +10,7 @@
 
 #include <cstdint>
 #include <vector>
-#include <functional>
+#include "FrameView.hpp"
 
 namespace command {
 
@@ -29,6 +29,7 @@ enum class COMMAND_ID{
 	GPS,
 	IMU,
 	DecentLog,
+	ImuCompact,
 	Last
 };
 
@@ -37,28 +38,48 @@ class Base {
 	COMMAND_ID id = COMMAND_ID::Last;
 
 protected:
-	std::function<void(void)> callback = [](void){};
 	void copy(const void* src, const void* dist, const uint8_t len);
+	std::vector<uint8_t> transmitToVector(uint8_t len){
+		std::vector<uint8_t> res(len);
+		res.resize(transmit(res.data(), len));
+		return res;
+	}
 
 public:
 	Base();
+
+	/*
+	 * Decode received frame **body**.
+	 * The view points into the receive buffer of CommandManager and is only valid during this call.
+	 * The default implementation copies the body and forwards it to onReceive(std::vector<uint8_t>&)
+	 * so that handlers which only implement the vector version keep working.
+	 */
+	virtual COMMAND_ID onReceive(const FrameView &body);
+
+	/*
+	 * Compatibility entry point. Allocates, so CommandManager does not call this directly.
+	 */
 	virtual COMMAND_ID onReceive(std::vector<uint8_t> &body){
 		return COMMAND_ID::Last;
 	};
 
+	/*
+	 * Write transmit frame **body** into body and return its length.
+	 * This function shuold be called throudh CommandManager::transmit(COMMAND_ID).
+	 * Returns 0 when the body does not fit in capacity.
+	 * The default implementation copies the result of transmit() for handlers which only implement the vector version.
+	 */
+	virtual uint8_t transmit(uint8_t* body, uint8_t capacity);
+
 	/* 
 	 * Construct transmit frame **body**.
-	 * This function shuold be called throudh CommandManager::transmit(COMMAND_ID).
+	 * Compatibility entry point. Allocates, so CommandManager does not call this directly.
 	 * The return vector is data body
 	 */
 	virtual std::vector<uint8_t> transmit(){
 		return std::vector<uint8_t>();
 	}
 
-	void setCallback(std::function<void(void)> callback){
-		this->callback = callback;
-	}
-
 //	virtual uint8_t getDataBodyLen(){
 //		return dataBodyLen;
 //	}
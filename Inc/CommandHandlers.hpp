@@ -10,23 +10,37 @@
 
 #include "CommandHandlerBase.h"
 #include "CommandDataType.hpp"
+#include "CommandWireSchema.hpp"
+#include "Callback.hpp"
 
 namespace command{
 
 class ConnectionCheck : public Base{
-    static constexpr uint8_t dataBodyLen = 1;
+    // 7-bit data and the loopback flag in the most significant bit
+    using Wire = wire::Format<wire::Packed<uint8_t, wire::ByteOrder::Little, wire::BitField<0, 7>, wire::Flag<7>>>;
+    static constexpr uint8_t dataBodyLen = Wire::size;
     static constexpr COMMAND_ID id = COMMAND_ID::ConnectionCheck;
 
     uint8_t data = 0;
     bool isLoopback = false;
-    std::function<void(uint8_t&, bool&)> update = [](uint8_t&, bool&){};
+    Callback<void(void)> callback;
+    Callback<void(uint8_t&, bool&)> update;
     
 public:
     ConnectionCheck() = default;
-    ConnectionCheck(std::function<void(uint8_t&, bool&)> update):update(update){}
-    COMMAND_ID onReceive(std::vector<uint8_t> &body);
-	std::vector<uint8_t> transmit();
-    void setUpdate(std::function<void(uint8_t&, bool&)> func){
+    ConnectionCheck(Callback<void(uint8_t&, bool&)> update):update(update){}
+    COMMAND_ID onReceive(const FrameView &body) override;
+    COMMAND_ID onReceive(std::vector<uint8_t> &body) override {
+        return onReceive(FrameView(body.data(), body.size()));
+    }
+    uint8_t transmit(uint8_t* body, uint8_t capacity) override;
+    std::vector<uint8_t> transmit() override {
+        return transmitToVector(dataBodyLen);
+    }
+    void setCallback(Callback<void(void)> func){
+        callback = func;
+    }
+    void setUpdate(Callback<void(uint8_t&, bool&)> func){
         update = func;
     }
     uint8_t getData() const {
@@ -42,30 +56,30 @@ public:
 };
 
 class SensorStatus : public Base{
-    static constexpr uint8_t dataBodyLen = 1;
+    static constexpr uint8_t dataBodyLen = wire::Schema<CommandDataType::SensorStatus>::Format::size;
     static constexpr COMMAND_ID id = COMMAND_ID::SensorStatus;
 
     CommandDataType::SensorStatus data;
-    const uint8_t tofOffset = 5;
-    const uint8_t cameraOffset = 4;
-    const uint8_t barometerOffset = 3;
-    const uint8_t magnetMeterOffset = 2;
-    const uint8_t imuOffset = 1;
-    const uint8_t gpsOffset = 0;
-    std::function<void(CommandDataType::SensorStatus&)> callback = [](CommandDataType::SensorStatus&){ };
-    std::function<void(CommandDataType::SensorStatus&)> update = [](CommandDataType::SensorStatus&){ };
+    Callback<void(CommandDataType::SensorStatus&)> callback;
+    Callback<void(CommandDataType::SensorStatus&)> update;
     
 public:
     SensorStatus() = default;
     explicit SensorStatus(const CommandDataType::SensorStatus &data):data(data){}
-    SensorStatus(std::function<void(CommandDataType::SensorStatus&)> update,
+    SensorStatus(Callback<void(CommandDataType::SensorStatus&)> update,
                  const CommandDataType::SensorStatus &data = CommandDataType::SensorStatus()):data(data),update(update){}
-    COMMAND_ID onReceive(std::vector<uint8_t> &body);
-    void setCallback(std::function<void(CommandDataType::SensorStatus&)> func){
+    COMMAND_ID onReceive(const FrameView &body) override;
+    COMMAND_ID onReceive(std::vector<uint8_t> &body) override {
+        return onReceive(FrameView(body.data(), body.size()));
+    }
+    void setCallback(Callback<void(CommandDataType::SensorStatus&)> func){
         callback = func;
     }
-	std::vector<uint8_t> transmit();
-    void setUpdate(std::function<void(CommandDataType::SensorStatus&)> func){
+    uint8_t transmit(uint8_t* body, uint8_t capacity) override;
+    std::vector<uint8_t> transmit() override {
+        return transmitToVector(dataBodyLen);
+    }
+    void setUpdate(Callback<void(CommandDataType::SensorStatus&)> func){
         update = func;
     }
     const CommandDataType::SensorStatus& getData() const {
@@ -81,15 +95,22 @@ public:
 };
 
 class Request : public Base{
-    static constexpr uint8_t dataBodyLen = 1;
+    using Wire = wire::Format<wire::Enum<COMMAND_ID>>;
+    static constexpr uint8_t dataBodyLen = Wire::size;
     static constexpr COMMAND_ID id = COMMAND_ID::Request;
 
     COMMAND_ID requestID = COMMAND_ID::Last;
 public:
     Request() = default;
     explicit Request(COMMAND_ID id):requestID(id){}
-    COMMAND_ID onReceive(std::vector<uint8_t> &body);
-	std::vector<uint8_t> transmit();
+    COMMAND_ID onReceive(const FrameView &body) override;
+    COMMAND_ID onReceive(std::vector<uint8_t> &body) override {
+        return onReceive(FrameView(body.data(), body.size()));
+    }
+    uint8_t transmit(uint8_t* body, uint8_t capacity) override;
+    std::vector<uint8_t> transmit() override {
+        return transmitToVector(dataBodyLen);
+    }
 
     void setRequestCommandId(COMMAND_ID id){
         requestID = id;
@@ -101,25 +122,31 @@ public:
 };
 
 class Goal : public Base{
-    static constexpr uint8_t dataBodyLen = 16;
+    static constexpr uint8_t dataBodyLen = wire::Schema<CommandDataType::Coordinates>::Format::size;
 	COMMAND_ID id = COMMAND_ID::Goal;
 
     CommandDataType::Coordinates data;
 
-    std::function<void(CommandDataType::Coordinates&)> callback = [](CommandDataType::Coordinates &coordinate) -> void {};
-    std::function<void(CommandDataType::Coordinates&)> update = [](CommandDataType::Coordinates&){};
+    Callback<void(CommandDataType::Coordinates&)> callback;
+    Callback<void(CommandDataType::Coordinates&)> update;
 
 public:
     Goal() = default;
     explicit Goal(const CommandDataType::Coordinates &data):data(data){}
-    Goal(std::function<void(CommandDataType::Coordinates&)> update,
+    Goal(Callback<void(CommandDataType::Coordinates&)> update,
          const CommandDataType::Coordinates &data = CommandDataType::Coordinates()):data(data),update(update){};
-    COMMAND_ID onReceive(std::vector<uint8_t> &body);
-    std::vector<uint8_t> transmit();
-    void setCallback(std::function<void(CommandDataType::Coordinates&)> callback){
+    COMMAND_ID onReceive(const FrameView &body) override;
+    COMMAND_ID onReceive(std::vector<uint8_t> &body) override {
+        return onReceive(FrameView(body.data(), body.size()));
+    }
+    uint8_t transmit(uint8_t* body, uint8_t capacity) override;
+    std::vector<uint8_t> transmit() override {
+        return transmitToVector(dataBodyLen);
+    }
+    void setCallback(Callback<void(CommandDataType::Coordinates&)> callback){
         this->callback = callback;
     }
-    void setUpdate(std::function<void(CommandDataType::Coordinates&)> func){
+    void setUpdate(Callback<void(CommandDataType::Coordinates&)> func){
         update = func;
     }
     const CommandDataType::Coordinates& getData() const {
@@ -134,24 +161,30 @@ public:
 };
 
 class Altitude : public Base{
-    static constexpr uint8_t dataBodyLen = 10;
+    static constexpr uint8_t dataBodyLen = wire::Schema<CommandDataType::Altitude>::Format::size;
     COMMAND_ID id = COMMAND_ID::Altitude;
 
     CommandDataType::Altitude data;
-    std::function<void(CommandDataType::Altitude&)> callback = [](CommandDataType::Altitude& data){};
-    std::function<void(CommandDataType::Altitude&)> update = [](CommandDataType::Altitude&){ };
+    Callback<void(CommandDataType::Altitude&)> callback;
+    Callback<void(CommandDataType::Altitude&)> update;
 
 public:
     Altitude() = default;
     explicit Altitude(const CommandDataType::Altitude &data):data(data){}
-    Altitude(std::function<void(CommandDataType::Altitude&)> update,
+    Altitude(Callback<void(CommandDataType::Altitude&)> update,
              const CommandDataType::Altitude &data = CommandDataType::Altitude()):data(data),update(update){}
-    COMMAND_ID onReceive(std::vector<uint8_t> &body);
-    std::vector<uint8_t> transmit();
-    void setCallback(std::function<void(CommandDataType::Altitude&)> callback){
+    COMMAND_ID onReceive(const FrameView &body) override;
+    COMMAND_ID onReceive(std::vector<uint8_t> &body) override {
+        return onReceive(FrameView(body.data(), body.size()));
+    }
+    uint8_t transmit(uint8_t* body, uint8_t capacity) override;
+    std::vector<uint8_t> transmit() override {
+        return transmitToVector(dataBodyLen);
+    }
+    void setCallback(Callback<void(CommandDataType::Altitude&)> callback){
         this->callback = callback;
     }
-    void setUpdate(std::function<void(CommandDataType::Altitude&)> func){
+    void setUpdate(Callback<void(CommandDataType::Altitude&)> func){
         update = func;
     }
     const CommandDataType::Altitude& getData() const {
@@ -166,23 +199,30 @@ public:
 };
 
 class Mode : public Base{
-    static constexpr uint8_t dataBodyLen = 1;
+    using Wire = wire::Format<wire::Scalar<uint8_t>>;
+    static constexpr uint8_t dataBodyLen = Wire::size;
     COMMAND_ID id = COMMAND_ID::Mode;
 
     uint8_t data = 0;
-    std::function<void(uint8_t)> callback = [](uint8_t mode){};
-    std::function<void(uint8_t&)> update = [](uint8_t&){};
+    Callback<void(uint8_t)> callback;
+    Callback<void(uint8_t&)> update;
 
 public:
     Mode() = default;
     explicit Mode(uint8_t data):data(data){}
-    Mode(std::function<void(uint8_t&)> update, uint8_t data = 0):data(data),update(update){}
-    COMMAND_ID onReceive(std::vector<uint8_t> &body);
-    std::vector<uint8_t> transmit() override;
-    void setCallback(std::function<void(uint8_t)> callback){
+    Mode(Callback<void(uint8_t&)> update, uint8_t data = 0):data(data),update(update){}
+    COMMAND_ID onReceive(const FrameView &body) override;
+    COMMAND_ID onReceive(std::vector<uint8_t> &body) override {
+        return onReceive(FrameView(body.data(), body.size()));
+    }
+    uint8_t transmit(uint8_t* body, uint8_t capacity) override;
+    std::vector<uint8_t> transmit() override {
+        return transmitToVector(dataBodyLen);
+    }
+    void setCallback(Callback<void(uint8_t)> callback){
         this->callback = callback;
     }
-    void setUpdate(std::function<void(uint8_t&)> func){
+    void setUpdate(Callback<void(uint8_t&)> func){
         update = func;
     }
     uint8_t getData() const {
@@ -197,24 +237,30 @@ public:
 };
 
 class AbsoluteNavigation : public Base {
-    static constexpr uint8_t dataBodyLen = 10;
+    static constexpr uint8_t dataBodyLen = wire::Schema<CommandDataType::AbsoluteNavigation>::Format::size;
     COMMAND_ID id = COMMAND_ID::AbsoluteNavigationLog;
 
     CommandDataType::AbsoluteNavigation data;
-    std::function<void(CommandDataType::AbsoluteNavigation&)> callback = [](CommandDataType::AbsoluteNavigation& data){};
-    std::function<void(CommandDataType::AbsoluteNavigation&)> update = [](CommandDataType::AbsoluteNavigation&){ };
+    Callback<void(CommandDataType::AbsoluteNavigation&)> callback;
+    Callback<void(CommandDataType::AbsoluteNavigation&)> update;
 
 public:
     AbsoluteNavigation() = default;
     explicit AbsoluteNavigation(const CommandDataType::AbsoluteNavigation &data):data(data){}
-    AbsoluteNavigation(std::function<void(CommandDataType::AbsoluteNavigation&)> update,
+    AbsoluteNavigation(Callback<void(CommandDataType::AbsoluteNavigation&)> update,
                        const CommandDataType::AbsoluteNavigation &data = CommandDataType::AbsoluteNavigation()):data(data),update(update){}
-    COMMAND_ID onReceive(std::vector<uint8_t> &body);
-    std::vector<uint8_t> transmit();
-    void setCallback(std::function<void(CommandDataType::AbsoluteNavigation&)> callback){
+    COMMAND_ID onReceive(const FrameView &body) override;
+    COMMAND_ID onReceive(std::vector<uint8_t> &body) override {
+        return onReceive(FrameView(body.data(), body.size()));
+    }
+    uint8_t transmit(uint8_t* body, uint8_t capacity) override;
+    std::vector<uint8_t> transmit() override {
+        return transmitToVector(dataBodyLen);
+    }
+    void setCallback(Callback<void(CommandDataType::AbsoluteNavigation&)> callback){
         this->callback = callback;
     }
-    void setUpdate(std::function<void(CommandDataType::AbsoluteNavigation&)> func){
+    void setUpdate(Callback<void(CommandDataType::AbsoluteNavigation&)> func){
         update = func;
     }
     const CommandDataType::AbsoluteNavigation& getData() const {
@@ -229,24 +275,30 @@ public:
 };
 
 class RelativeNavigation : public Base {
-    static constexpr uint8_t dataBodyLen = 16;
+    static constexpr uint8_t dataBodyLen = wire::Schema<CommandDataType::RelativeNavigation>::Format::size;
     COMMAND_ID id = COMMAND_ID::RelativeNavigationLog;
 
     CommandDataType::RelativeNavigation data;
-    std::function<void(CommandDataType::RelativeNavigation&)> callback = [](CommandDataType::RelativeNavigation& data){};
-    std::function<void(CommandDataType::RelativeNavigation&)> update = [](CommandDataType::RelativeNavigation&){ };
+    Callback<void(CommandDataType::RelativeNavigation&)> callback;
+    Callback<void(CommandDataType::RelativeNavigation&)> update;
 
 public:
     RelativeNavigation() = default;
     explicit RelativeNavigation(const CommandDataType::RelativeNavigation &data):data(data){}
-    RelativeNavigation(std::function<void(CommandDataType::RelativeNavigation&)> update,
+    RelativeNavigation(Callback<void(CommandDataType::RelativeNavigation&)> update,
                        const CommandDataType::RelativeNavigation &data = CommandDataType::RelativeNavigation()):data(data),update(update){}
-    COMMAND_ID onReceive(std::vector<uint8_t> &body);
-    std::vector<uint8_t> transmit();
-    void setCallback(std::function<void(CommandDataType::RelativeNavigation&)> callback){
+    COMMAND_ID onReceive(const FrameView &body) override;
+    COMMAND_ID onReceive(std::vector<uint8_t> &body) override {
+        return onReceive(FrameView(body.data(), body.size()));
+    }
+    uint8_t transmit(uint8_t* body, uint8_t capacity) override;
+    std::vector<uint8_t> transmit() override {
+        return transmitToVector(dataBodyLen);
+    }
+    void setCallback(Callback<void(CommandDataType::RelativeNavigation&)> callback){
         this->callback = callback;
     }
-    void setUpdate(std::function<void(CommandDataType::RelativeNavigation&)> func){
+    void setUpdate(Callback<void(CommandDataType::RelativeNavigation&)> func){
         update = func;
     }
     const CommandDataType::RelativeNavigation& getData() const {
@@ -261,23 +313,29 @@ public:
 };
 
 class ServoConfig : public Base {
-    static constexpr uint8_t dataBodyLen = 7;
+    static constexpr uint8_t dataBodyLen = wire::Schema<CommandDataType::ServoConfig>::Format::size;
 
     CommandDataType::ServoConfig data;
-    std::function<void(CommandDataType::ServoConfig&)> callback = [](CommandDataType::ServoConfig& data){};
-    std::function<void(CommandDataType::ServoConfig&)> update = [](CommandDataType::ServoConfig&){ };
+    Callback<void(CommandDataType::ServoConfig&)> callback;
+    Callback<void(CommandDataType::ServoConfig&)> update;
 
 public:
     ServoConfig() = default;
     explicit ServoConfig(const CommandDataType::ServoConfig &data):data(data){}
-    ServoConfig(std::function<void(CommandDataType::ServoConfig&)> update,
+    ServoConfig(Callback<void(CommandDataType::ServoConfig&)> update,
                 const CommandDataType::ServoConfig &data = CommandDataType::ServoConfig()):data(data),update(update){}
-    COMMAND_ID onReceive(std::vector<uint8_t> &body);
-    std::vector<uint8_t> transmit();
-    void setCallback(std::function<void(CommandDataType::ServoConfig&)> callback){
+    COMMAND_ID onReceive(const FrameView &body) override;
+    COMMAND_ID onReceive(std::vector<uint8_t> &body) override {
+        return onReceive(FrameView(body.data(), body.size()));
+    }
+    uint8_t transmit(uint8_t* body, uint8_t capacity) override;
+    std::vector<uint8_t> transmit() override {
+        return transmitToVector(dataBodyLen);
+    }
+    void setCallback(Callback<void(CommandDataType::ServoConfig&)> callback){
         this->callback = callback;
     }
-    void setUpdate(std::function<void(CommandDataType::ServoConfig&)> func){
+    void setUpdate(Callback<void(CommandDataType::ServoConfig&)> func){
         update = func;
     }
     const CommandDataType::ServoConfig& getData() const {
@@ -302,23 +360,29 @@ class ServoConfig_stabilizer : public ServoConfig {
 };
 
 class Gps : public Base{
-    static constexpr uint8_t dataBodyLen = 17;
+    static constexpr uint8_t dataBodyLen = wire::Schema<CommandDataType::GPS>::Format::size;
 
     CommandDataType::GPS data;
-    std::function<void(CommandDataType::GPS&)> callback = [](CommandDataType::GPS& data){};
-    std::function<void(CommandDataType::GPS&)> update = [](CommandDataType::GPS&){ };
+    Callback<void(CommandDataType::GPS&)> callback;
+    Callback<void(CommandDataType::GPS&)> update;
 
 public:
     Gps() = default;
     explicit Gps(const CommandDataType::GPS &data):data(data){}
-    Gps(std::function<void(CommandDataType::GPS&)> update,
+    Gps(Callback<void(CommandDataType::GPS&)> update,
                 const CommandDataType::GPS &data = CommandDataType::GPS()):data(data),update(update){}
-    COMMAND_ID onReceive(std::vector<uint8_t> &body);
-    std::vector<uint8_t> transmit();
-    void setCallback(std::function<void(CommandDataType::GPS&)> callback){
+    COMMAND_ID onReceive(const FrameView &body) override;
+    COMMAND_ID onReceive(std::vector<uint8_t> &body) override {
+        return onReceive(FrameView(body.data(), body.size()));
+    }
+    uint8_t transmit(uint8_t* body, uint8_t capacity) override;
+    std::vector<uint8_t> transmit() override {
+        return transmitToVector(dataBodyLen);
+    }
+    void setCallback(Callback<void(CommandDataType::GPS&)> callback){
         this->callback = callback;
     }
-    void setUpdate(std::function<void(CommandDataType::GPS&)> func){
+    void setUpdate(Callback<void(CommandDataType::GPS&)> func){
         update = func;
     }
     const CommandDataType::GPS& getData() const {
@@ -333,23 +397,29 @@ public:
 };
 
 class Imu : public Base{
-    static constexpr uint8_t dataBodyLen = 36;
+    static constexpr uint8_t dataBodyLen = wire::Schema<CommandDataType::IMU>::Format::size;
 
     CommandDataType::IMU data;
-    std::function<void(CommandDataType::IMU&)> callback = [](CommandDataType::IMU& data){};
-    std::function<void(CommandDataType::IMU&)> update = [](CommandDataType::IMU&){ };
+    Callback<void(CommandDataType::IMU&)> callback;
+    Callback<void(CommandDataType::IMU&)> update;
 
 public:
     Imu() = default;
     explicit Imu(const CommandDataType::IMU &data):data(data){}
-    Imu(std::function<void(CommandDataType::IMU&)> update,
+    Imu(Callback<void(CommandDataType::IMU&)> update,
                 const CommandDataType::IMU &data = CommandDataType::IMU()):data(data),update(update){}
-    COMMAND_ID onReceive(std::vector<uint8_t> &body);
-    std::vector<uint8_t> transmit();
-    void setCallback(std::function<void(CommandDataType::IMU&)> callback){
+    COMMAND_ID onReceive(const FrameView &body) override;
+    COMMAND_ID onReceive(std::vector<uint8_t> &body) override {
+        return onReceive(FrameView(body.data(), body.size()));
+    }
+    uint8_t transmit(uint8_t* body, uint8_t capacity) override;
+    std::vector<uint8_t> transmit() override {
+        return transmitToVector(dataBodyLen);
+    }
+    void setCallback(Callback<void(CommandDataType::IMU&)> callback){
         this->callback = callback;
     }
-    void setUpdate(std::function<void(CommandDataType::IMU&)> func){
+    void setUpdate(Callback<void(CommandDataType::IMU&)> func){
         update = func;
     }
     const CommandDataType::IMU& getData() const {
@@ -364,19 +434,25 @@ public:
 };
 
 class DecentLog: public Base{
-	static constexpr uint8_t dataBodyLen = 5;
+	static constexpr uint8_t dataBodyLen = wire::Schema<CommandDataType::DecentLog>::Format::size;
 	CommandDataType::DecentLog data;
 
-    std::function<void(CommandDataType::DecentLog&)> callback = [](CommandDataType::DecentLog& data){};
-    std::function<void(CommandDataType::DecentLog&)> update = [](CommandDataType::DecentLog&){ };
+    Callback<void(CommandDataType::DecentLog&)> callback;
+    Callback<void(CommandDataType::DecentLog&)> update;
 public:
 	DecentLog() = default;
-	COMMAND_ID onReceive(std::vector<uint8_t> &body);
-	std::vector<uint8_t> transmit();
-	void setCallback(std::function<void(CommandDataType::DecentLog&)> callback){
+	COMMAND_ID onReceive(const FrameView &body) override;
+	COMMAND_ID onReceive(std::vector<uint8_t> &body) override {
+		return onReceive(FrameView(body.data(), body.size()));
+	}
+	uint8_t transmit(uint8_t* body, uint8_t capacity) override;
+	std::vector<uint8_t> transmit() override {
+		return transmitToVector(dataBodyLen);
+	}
+	void setCallback(Callback<void(CommandDataType::DecentLog&)> callback){
 		this->callback = callback;
 	}
-	void setUpdate(std::function<void(CommandDataType::DecentLog&)> func){
+	void setUpdate(Callback<void(CommandDataType::DecentLog&)> func){
 		update = func;
 	}
     const CommandDataType::DecentLog& getData() const {
@@ -389,6 +465,54 @@ public:
 		return dataBodyLen;
 	}
 };
+
+/*
+ * IMU in the compact encoding of wire::CompactImu (18 bytes instead of 36).
+ * Receives into the same CommandDataType::IMU as Imu, so a link can send either one.
+ */
+class ImuCompact : public Base{
+    static constexpr uint8_t dataBodyLen = wire::CompactImu::Format::size;
+
+    CommandDataType::IMU data;
+    wire::ImuFullScale scale;
+    Callback<void(CommandDataType::IMU&)> callback;
+    Callback<void(CommandDataType::IMU&)> update;
+
+public:
+    ImuCompact() = default;
+    explicit ImuCompact(const wire::ImuFullScale &scale):scale(scale){}
+    ImuCompact(Callback<void(CommandDataType::IMU&)> update,
+               const wire::ImuFullScale &scale = wire::ImuFullScale()):scale(scale),update(update){}
+    COMMAND_ID onReceive(const FrameView &body) override;
+    COMMAND_ID onReceive(std::vector<uint8_t> &body) override {
+        return onReceive(FrameView(body.data(), body.size()));
+    }
+    uint8_t transmit(uint8_t* body, uint8_t capacity) override;
+    std::vector<uint8_t> transmit() override {
+        return transmitToVector(dataBodyLen);
+    }
+    void setCallback(Callback<void(CommandDataType::IMU&)> callback){
+        this->callback = callback;
+    }
+    void setUpdate(Callback<void(CommandDataType::IMU&)> func){
+        update = func;
+    }
+    const CommandDataType::IMU& getData() const {
+        return data;
+    }
+    void setData(const CommandDataType::IMU &value){
+        data = value;
+    }
+    const wire::ImuFullScale& getFullScale() const {
+        return scale;
+    }
+    void setFullScale(const wire::ImuFullScale &value){
+        scale = value;
+    }
+    static constexpr uint8_t getDataBodyLen(){
+		return dataBodyLen;
+	}
+};
 } /*namespace command*/
 
 #endif /* COMMAND_INC_COMMANDHANDLERS_HPP_ */
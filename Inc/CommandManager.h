@@ -10,6 +10,11 @@
 
 #include "CommandHandlerBase.h"
 #include "CommandHandlers.hpp"
+#include "ReceiveRing.hpp"
+#include "DmaReceiveRing.hpp"
+#include "FrameIntegrity.hpp"
+#include "FrameFraming.hpp"
+#include "LinkStatistics.hpp"
 #include <array>
 #include <algorithm>
 
@@ -20,7 +25,43 @@ constexpr ForwardIterator getMaxElement(const ForwardIterator first, const Forwa
 
 namespace command {
 
-class CommandManager {
+/*
+ * Result of CommandManager::processReceiveAll().
+ */
+struct ReceiveSummary {
+	uint16_t frames = 0;       // number of commands dispatched to a handler, counting each entry of a superframe
+	uint32_t ids = 0;          // bit n is set when a command of COMMAND_ID n was dispatched
+	uint32_t skippedBytes = 0; // bytes discarded while searching for a frame
+
+	bool seen(COMMAND_ID id) const {
+		return ids & (uint32_t(1) << static_cast<uint8_t>(id));
+	}
+};
+static_assert(static_cast<uint8_t>(COMMAND_ID::Last) <= 32, "ReceiveSummary::ids can not hold every COMMAND_ID");
+
+/*
+ * Compile-time configuration of BasicCommandManager.
+ * Derive from it and redefine the members to change them, e.g.
+ *   struct GroundConfig : DefaultManagerConfig { static constexpr size_t rxCapacity = 8192; };
+ */
+struct DefaultManagerConfig {
+	// Size of the receive ring in bytes. Must be a power of two and hold at least two of the longest frame.
+	static constexpr size_t rxCapacity = 128;
+	// Receive ring: ReceiveRing filled by receive(), or DmaReceiveRing filled by a circular DMA.
+	template<size_t Size>
+	using Ring = ReceiveRing<Size>;
+	// Integrity check of ID and body: integrity::Sum8, Crc8, Crc16Ccitt or Crc32c. Both ends must agree.
+	using Integrity = integrity::Sum8;
+	// Wire framing: framing::Delimited (START_BYTE ... STOP_BYTE) or framing::Cobs (zero delimited).
+	using Framing = framing::Delimited;
+	// Longest superframe on the wire in bytes, 0 disables superframes. See constructSuperframeToBuffer().
+	static constexpr size_t superframeMtu = 0;
+	// Link and parser counters: statistics::Counting, or statistics::Null to compile them out.
+	using Statistics = statistics::Counting;
+};
+
+template<class Config = DefaultManagerConfig>
+class BasicCommandManager {
 	static constexpr std::array<uint8_t, (uint8_t)COMMAND_ID::Last> commandLen = {
         ConnectionCheck::getDataBodyLen(),
         SensorStatus::getDataBodyLen(),
@@ -36,51 +77,216 @@ class CommandManager {
         Gps::getDataBodyLen(),
         Imu::getDataBodyLen(),
 		DecentLog::getDataBodyLen(),
+		ImuCompact::getDataBodyLen(),
 	};
 
-    std::array<uint8_t, static_cast<size_t>((*getMaxElement(commandLen.begin(), commandLen.end())+4)*2)> rBuffer = {};
-    uint8_t copyCursor = 0;
-    uint8_t readCursor = 0;
+	using Integrity = typename Config::Integrity;
+	using Framing = typename Config::Framing;
+	using Statistics = typename Config::Statistics;
+
+public:
+	// Framing + ID + CHECK
+	static constexpr uint8_t FRAME_OVERHEAD = Framing::overhead + 1 + Integrity::size;
+	// Framing + ID + DATA + CHECK of the longest command
+	static constexpr uint8_t MAX_FRAME_LEN = *getMaxElement(commandLen.begin(), commandLen.end()) + FRAME_OVERHEAD;
+
+	// ID byte which marks a superframe. It is never a COMMAND_ID.
+	static constexpr uint8_t SUPERFRAME_ID = 0xff;
+	// Framing + SUPERFRAME_ID + LENGTH + CHECK
+	static constexpr uint8_t SUPERFRAME_OVERHEAD = FRAME_OVERHEAD + 1;
+	static constexpr size_t SUPERFRAME_MTU = Config::superframeMtu;
+	// Longest frame rBuffer has to hold
+	static constexpr size_t MAX_RECEIVE_LEN = std::max<size_t>(MAX_FRAME_LEN, SUPERFRAME_MTU);
+
+private:
+	static_assert(Config::rxCapacity >= 2 * MAX_RECEIVE_LEN, "rxCapacity must hold at least two of the longest frame");
+	static_assert(MAX_RECEIVE_LEN - Framing::overhead <= Framing::maxRawLen, "Longest frame is too long for the framing");
+	static_assert(SUPERFRAME_MTU == 0 || SUPERFRAME_MTU >= MAX_FRAME_LEN + 1, "superframeMtu must fit the longest command");
+	static_assert(static_cast<uint8_t>(COMMAND_ID::Last) < SUPERFRAME_ID, "SUPERFRAME_ID collides with a COMMAND_ID");
+
+public:
+	using Ring = typename Config::template Ring<Config::rxCapacity>;
+
+private:
+    // receive() (or the DMA) writes and processReceive() reads, possibly from an interrupt handler and the main loop.
+    Ring rBuffer;
+    // Written by the parser only.
+    Statistics stats;
+    Callback<void(COMMAND_ID, const FrameView&)> frameObserver;
 
-	const uint8_t START_BYTE = 's';
-	const uint8_t STOP_BYTE = 'e';
 protected:
     std::array<command::Base*, (uint8_t)COMMAND_ID::Last> commandHandlers;
 
 public:
-	CommandManager();
+	BasicCommandManager(){
+		// Initialize all handlers to nullptr
+		commandHandlers.fill(nullptr);
+	}
+	virtual ~BasicCommandManager() = default;
+
 	Base*& operator[](COMMAND_ID id){
 		return commandHandlers[static_cast<uint8_t>(id)];
 	}
+
+	/*
+	 * The receive ring, e.g. to start the DMA on a DmaReceiveRing and report its write position.
+	 */
+	Ring& receiveRing(){
+		return rBuffer;
+	}
+
+	/*
+	 * Counters since the last resetStatistics(). It can be read while the parser runs
+	 * in another context; call it and resetStatistics() from the same context.
+	 */
+	LinkStatistics statistics() const {
+		return stats.snapshot(rBuffer.received(), rBuffer.dropped());
+	}
+
+	void resetStatistics(){
+		stats.reset(rBuffer.received(), rBuffer.dropped());
+	}
+
+	/*
+	 * observer(id, body) is called with every validated command before it is dispatched,
+	 * including commands without a handler and each entry of a superframe, e.g. to record the link.
+	 * body is only valid during the call.
+	 */
+	void setFrameObserver(Callback<void(COMMAND_ID, const FrameView&)> observer){
+		frameObserver = observer;
+	}
+
+	static constexpr uint8_t getFrameLen(COMMAND_ID id){
+		return commandLen[static_cast<uint8_t>(id)] + FRAME_OVERHEAD;
+	}
   	
-	std::vector<uint8_t> constructTransmitFrame(const COMMAND_ID id);
-	void constructTransmitFrameToBuffer(const COMMAND_ID id, uint8_t* buffer, uint8_t& length);
-	void transmit(const COMMAND_ID id);
+	std::vector<uint8_t> constructTransmitFrame(const COMMAND_ID id){
+		// Check if handler is valid before using
+		if(static_cast<uint8_t>(id) >= static_cast<uint8_t>(COMMAND_ID::Last) || commandHandlers[static_cast<uint8_t>(id)] == nullptr){
+			return std::vector<uint8_t>();
+		}
+		std::vector<uint8_t> res(getFrameLen(id));
+		res.resize(constructTransmitFrameInto(id, res.data(), res.size()));
+
+		return res;
+	}
+
+	/*
+	 * Legacy form: buffer must hold MAX_FRAME_LEN bytes and length receives the frame length, 0 on failure.
+	 * New code uses constructTransmitFrameInto(), which checks the capacity.
+	 */
+	void constructTransmitFrameToBuffer(const COMMAND_ID id, uint8_t* buffer, uint8_t& length){
+		length = constructTransmitFrameInto(id, buffer, static_cast<size_t>(MAX_FRAME_LEN));
+	}
+
+	/*
+	 * Serialize the whole frame of id into buffer (e.g. a DMA TX buffer) without allocating.
+	 * Returns the frame length, or 0 when the handler is missing or the frame does not fit in capacity.
+	 */
+	size_t constructTransmitFrameInto(const COMMAND_ID id, uint8_t* buffer, size_t capacity){
+		// Check if handler is valid before using
+		if(buffer == nullptr){
+			return 0;
+		}
+		if(static_cast<uint8_t>(id) >= static_cast<uint8_t>(COMMAND_ID::Last) || commandHandlers[static_cast<uint8_t>(id)] == nullptr){
+			return 0;
+		}
+		const uint8_t bodyLen = commandLen[static_cast<uint8_t>(id)];
+		if(capacity < static_cast<size_t>(bodyLen) + FRAME_OVERHEAD){
+			return 0;
+		}
+
+		//the raw frame starts after the first framing byte
+		uint8_t pos = 1;
+		buffer[pos++] = static_cast<uint8_t>(id);
+		if(commandHandlers[static_cast<uint8_t>(id)]->transmit(buffer + pos, bodyLen) != bodyLen){
+			return 0;
+		}
+
+		return finishFrame(buffer, pos + bodyLen);
+	}
+
+	/*
+	 * Serialize a frame of id with the given body without a handler, e.g. to replay a recorded command.
+	 * Returns the frame length, or 0 when id is not valid, body does not have the length of id or the frame
+	 * does not fit in capacity.
+	 */
+	static size_t constructFrameToBuffer(const COMMAND_ID id, const FrameView &body, uint8_t* buffer, size_t capacity){
+		if(buffer == nullptr || static_cast<uint8_t>(id) >= static_cast<uint8_t>(COMMAND_ID::Last)){
+			return 0;
+		}
+		if(body.size() != commandLen[static_cast<uint8_t>(id)] || capacity < body.size() + FRAME_OVERHEAD){
+			return 0;
+		}
+		buffer[1] = static_cast<uint8_t>(id);
+		body.copy(0, buffer + 2, body.size());
+		return finishFrame(buffer, 2 + body.size());
+	}
+
+	/*
+	 * Pack the bodies of ids, in order, into one superframe in buffer:
+	 *   Framing + SUPERFRAME_ID + LENGTH + (ID + DATA)... + CHECK
+	 * LENGTH is the number of entry bytes. The receiver dispatches every entry as if it was sent in its own frame.
+	 * Packing stops at the first command which does not fit in min(capacity, SUPERFRAME_MTU) bytes and
+	 * packed returns how many ids were consumed, so the rest can go into the next superframe.
+	 * ids without a handler are skipped. Returns the frame length, or 0 when nothing was packed.
+	 */
+	size_t constructSuperframeToBuffer(const COMMAND_ID* ids, size_t count, uint8_t* buffer, size_t capacity, size_t &packed){
+		packed = 0;
+		if(SUPERFRAME_MTU == 0 || ids == nullptr || buffer == nullptr){
+			return 0;
+		}
+		const size_t limit = std::min(capacity, SUPERFRAME_MTU);
+		if(limit < SUPERFRAME_OVERHEAD){
+			return 0;
+		}
 
+		//entries start after the first framing byte, SUPERFRAME_ID and LENGTH
+		const size_t entryStart = 3;
+		const size_t entryEnd = entryStart + limit - SUPERFRAME_OVERHEAD;
+		size_t pos = entryStart;
+		for(; packed < count; packed++){
+			const uint8_t id = static_cast<uint8_t>(ids[packed]);
+			if(id >= static_cast<uint8_t>(COMMAND_ID::Last) || commandHandlers[id] == nullptr){
+				continue;
+			}
+			const uint8_t bodyLen = commandLen[id];
+			if(pos + 1 + bodyLen > entryEnd){
+				break;
+			}
+			buffer[pos] = id;
+			if(commandHandlers[id]->transmit(buffer + pos + 1, bodyLen) == bodyLen){
+				pos += 1 + bodyLen;
+			}
+		}
+		if(pos == entryStart){
+			return 0;
+		}
+
+		buffer[1] = SUPERFRAME_ID;
+		buffer[2] = static_cast<uint8_t>(pos - entryStart);
+		return finishFrame(buffer, pos);
+	}
+
+	/*
+	 * Send the frame of id. Called for the response returned by a handler's onReceive().
+	 * Override it to hand frames to the UART; the default does nothing.
+	 */
+	virtual void transmit(const COMMAND_ID){
+	}
+
+	/*
+	 * Append received bytes to rBuffer.
+	 * This may be called from an interrupt handler while processReceive() runs in the main loop.
+	 * Bytes which do not fit in the free space of rBuffer are dropped.
+	 * Not available with DmaReceiveRing, which the DMA fills itself.
+	 */
 	template<typename _ForwardIterator>
     COMMAND_ID receive(_ForwardIterator __first, _ForwardIterator __last){
-        size_t len = std::distance(__first, __last);
-        if(len == 0){
-            return COMMAND_ID::Last;
-        }
-        if(len > rBuffer.size()){
-            resetBuffer();
+        if(__first == __last){
             return COMMAND_ID::Last;
         }
-
-        //avoid over-flow
-        if(rBuffer.size() < copyCursor + len){
-            size_t copyLen = rBuffer.size() - copyCursor;
-            if(copyLen > 0){
-                std::copy(__first, std::next(__first, copyLen), rBuffer.begin()+copyCursor);
-            }
-            std::advance(__first, copyLen);
-            len = std::distance(__first, __last);
-            copyCursor = 0;
-        }
-
-        std::copy(__first, __last, rBuffer.begin()+copyCursor);
-        copyCursor = (copyCursor + static_cast<uint16_t>(len)) % rBuffer.size();
+        rBuffer.push(__first, __last);
 
         return COMMAND_ID::Last;
 	}
@@ -96,57 +302,31 @@ public:
 	}
 
 	COMMAND_ID processReceive(){
-		if(copyCursor == readCursor){
-            return COMMAND_ID::Last;
-		}
-		int16_t reamingLen = (copyCursor - readCursor + static_cast<int16_t>(rBuffer.size())) % rBuffer.size();
-		if(reamingLen == 0){
-			reamingLen = rBuffer.size();
-		}
-        for(; reamingLen>1; reamingLen--){
-			if(rBuffer[readCursor] != START_BYTE){
-				readCursor = (readCursor+1)%rBuffer.size();
-				continue;
-			}
-			uint8_t possibleId = rBuffer[(readCursor+1)%rBuffer.size()];
-			if(possibleId >= static_cast<uint8_t>(COMMAND_ID::Last)){
-				//There is no valid id for possibleId.
-				readCursor = (readCursor+1)%rBuffer.size();
-				continue;
-			}
-			uint8_t frameLen = commandLen[possibleId]+4;
-			if(reamingLen < frameLen){
-				//Wait for next receive.
-				break;
-			}
-			if(rBuffer[(readCursor + frameLen - 1)%rBuffer.size()] != STOP_BYTE){
-				readCursor = (readCursor+1)%rBuffer.size();
-				continue;
-			}
+		size_t reamingLen = rBuffer.readable();
+		size_t scanBudget = reamingLen;
+		ReceiveSummary summary;
+		COMMAND_ID id = COMMAND_ID::Last;
+		processNextFrame(reamingLen, scanBudget, summary, id);
+		return id;
+	}
 
-			std::vector<uint8_t> frame(frameLen);
-			uint16_t copiedLen = 0;
-			uint16_t nextCursor = (readCursor + frameLen) % rBuffer.size();
-			if(readCursor < nextCursor){
-				// Data is contiguous
-				std::copy(rBuffer.begin()+readCursor, rBuffer.begin()+nextCursor, frame.begin());
-				copiedLen = frameLen;
-			} else {
-				// Data wraps around buffer
-				uint16_t firstPart = rBuffer.size() - readCursor;
-				std::copy(rBuffer.begin()+readCursor, rBuffer.end(), frame.begin());
-				copiedLen = firstPart;
-				uint16_t secondPart = nextCursor;
-				if(secondPart > 0){
-					std::copy(rBuffer.begin(), rBuffer.begin()+secondPart, frame.begin() + copiedLen);
-				}
+	/*
+	 * Parse and dispatch every complete frame in rBuffer in one pass.
+	 * maxFrames and maxBytes bound the work done per call; 0 means no limit.
+	 * The entries of a superframe are dispatched together, so they may exceed maxFrames.
+	 * Remaining data is kept for the next call.
+	 */
+	ReceiveSummary processReceiveAll(uint16_t maxFrames = 0, size_t maxBytes = 0){
+		ReceiveSummary summary;
+		size_t reamingLen = rBuffer.readable();
+		size_t scanBudget = (maxBytes == 0 || maxBytes > reamingLen) ? reamingLen : maxBytes;
+		while(maxFrames == 0 || summary.frames < maxFrames){
+			COMMAND_ID id = COMMAND_ID::Last;
+			if(!processNextFrame(reamingLen, scanBudget, summary, id)){
+				break;
 			}
-			COMMAND_ID id = onReceiveFrame(&*frame.begin(), &*frame.end());
-			readCursor = nextCursor;
-			reamingLen -= frameLen + 1;
-            return id;
 		}
-        return COMMAND_ID::Last;
+		return summary;
 	}
 
     COMMAND_ID onReceiveFrame(const uint8_t* __first, const uint8_t* __last){
@@ -154,47 +334,185 @@ public:
         if(__first == nullptr || __last == nullptr || __first >= __last){
             return COMMAND_ID::Last;
         }
-        //check minimum frame length (START + ID + DATA + CHECKSUM + STOP = at least 4 bytes)
-        if(__last - __first < 4){
+        return onReceiveFrame(FrameView(__first, __last - __first));
+    }
+
+    /*
+     * Validate one wire frame and dispatch it to its handler.
+     * With framing::Cobs the frame is decoded into a buffer on the stack first.
+     * For a superframe every entry is dispatched and the ID of the last one is returned.
+     */
+    COMMAND_ID onReceiveFrame(const FrameView &frame){
+        ReceiveSummary summary;
+        return dispatchFrame(frame, summary, true);
+    }
+
+    /*
+     * Validate and dispatch one wire frame like onReceiveFrame() without transmitting the responses
+     * of the handlers, e.g. to replay a recorded link.
+     */
+    COMMAND_ID onReplayFrame(const FrameView &frame){
+        ReceiveSummary summary;
+        return dispatchFrame(frame, summary, false);
+    }
+
+private:
+    /*
+     * Append the integrity check to the raw frame stored at buffer + 1 up to buffer + end and wrap it
+     * for the wire. Returns the frame length.
+     */
+    static size_t finishFrame(uint8_t* buffer, size_t end){
+        Integrity::store(buffer + end, integrity::compute<Integrity>(FrameView(buffer + 1, end - 1)));
+        return Framing::finish(buffer, end - 1 + Integrity::size);
+    }
+
+    /*
+     * Search the next frame in rBuffer and dispatch it.
+     * reamingLen is the number of unread bytes and scanBudget limits how many bytes may be consumed.
+     * Returns false when no complete frame can be found within the budget.
+     */
+    bool processNextFrame(size_t &reamingLen, size_t &scanBudget, ReceiveSummary &summary, COMMAND_ID &id){
+        auto frameLen = [](uint8_t possibleId, uint8_t next) -> size_t {
+            if(possibleId < static_cast<uint8_t>(COMMAND_ID::Last)){
+                return commandLen[possibleId] + FRAME_OVERHEAD;
+            }
+            if(SUPERFRAME_MTU > 0 && possibleId == SUPERFRAME_ID && size_t(next) + SUPERFRAME_OVERHEAD <= SUPERFRAME_MTU){
+                return size_t(next) + SUPERFRAME_OVERHEAD;
+            }
+            return 0;
+        };
+        while(reamingLen > 0 && scanBudget > 0){
+            const framing::Scan scan = Framing::scan(rBuffer, reamingLen, scanBudget, frameLen, MAX_RECEIVE_LEN);
+            if(scan.action == framing::Scan::Action::Wait){
+                return false;
+            }
+            if(scan.action == framing::Scan::Action::Skip){
+                rBuffer.consume(scan.len);
+                reamingLen -= scan.len;
+                scanBudget -= scan.len;
+                summary.skippedBytes += scan.len;
+                stats.count(LinkCounter::SkippedBytes, scan.len);
+                if(scan.reject == framing::Scan::Reject::BadId){
+                    stats.count(LinkCounter::BadId);
+                }else if(scan.reject == framing::Scan::Reject::Framing){
+                    stats.count(LinkCounter::BadFraming);
+                }
+                continue;
+            }
+
+            //Dispatch straight from rBuffer. A frame crossing the end of rBuffer is passed as two segments.
+            id = dispatchFrame(rBuffer.view(0, scan.len), summary, true);
+            rBuffer.consume(scan.len);
+            reamingLen -= scan.len;
+            scanBudget = scanBudget > scan.len ? scanBudget - scan.len : 0;
+            return true;
+        }
+        return false;
+    }
+
+    COMMAND_ID dispatchFrame(const FrameView &frame, ReceiveSummary &summary, bool respond){
+        //check minimum frame length (Framing + ID + DATA + CHECK = at least FRAME_OVERHEAD bytes)
+        if(frame.size() < FRAME_OVERHEAD || frame.size() > MAX_RECEIVE_LEN){
+            stats.count(LinkCounter::BadLength);
             return COMMAND_ID::Last;
         }
-        //validate frame
-        //check start and stop byte
-        if(*__first != START_BYTE || *(__last-1) != STOP_BYTE){
+        //validate framing
+        std::array<uint8_t, MAX_RECEIVE_LEN> scratch;
+        FrameView raw;
+        if(!Framing::unwrap(frame, scratch.data(), scratch.size(), raw)){
+            stats.count(LinkCounter::BadFraming);
             return COMMAND_ID::Last;
         }
-        //check sum
-        uint8_t sum = 0;
-        for(auto it = __first + 1; it < __last - 2; it++){
-            // exclude start byte and checksum/stop bytes
-            sum += *it;
+        if(raw.size() < 1 + Integrity::size){
+            stats.count(LinkCounter::BadLength);
+            return COMMAND_ID::Last;
         }
-        if(sum != *(__last - 2)){
+        //integrity check (exclude check bytes)
+        const size_t checkOffset = raw.size() - Integrity::size;
+        if(integrity::compute<Integrity>(raw.subview(0, checkOffset)) != Integrity::load(raw, checkOffset)){
+            stats.count(LinkCounter::BadChecksum);
             return COMMAND_ID::Last;
         }
 
-        const COMMAND_ID rid = static_cast<COMMAND_ID>(*(__first + 1));
+        if(SUPERFRAME_MTU > 0 && raw[0] == SUPERFRAME_ID){
+            return dispatchSuperframe(raw.subview(1, checkOffset - 1), summary, respond);
+        }
+        const COMMAND_ID rid = static_cast<COMMAND_ID>(raw[0]);
         if(static_cast<uint8_t>(rid) >= static_cast<uint8_t>(COMMAND_ID::Last)){
+            stats.count(LinkCounter::BadId);
             return COMMAND_ID::Last;
         }
-        std::vector<uint8_t> frameBody(__first+2, __last-2);
+        const FrameView frameBody = raw.subview(1, checkOffset - 1);
 
         //check body length
         if(frameBody.size() != commandLen[static_cast<uint8_t>(rid)]){
+            stats.count(LinkCounter::BadLength);
+            return COMMAND_ID::Last;
+        }
+        return dispatchCommand(rid, frameBody, summary, respond);
+    }
+
+    /*
+     * payload is LENGTH + (ID + DATA)...
+     * The whole payload is validated before any entry is dispatched.
+     */
+    COMMAND_ID dispatchSuperframe(const FrameView &payload, ReceiveSummary &summary, bool respond){
+        if(payload.size() < 1 || payload[0] != payload.size() - 1){
+            stats.count(LinkCounter::BadLength);
             return COMMAND_ID::Last;
         }
+        size_t pos = 1;
+        while(pos < payload.size()){
+            const uint8_t entryId = payload[pos];
+            if(entryId >= static_cast<uint8_t>(COMMAND_ID::Last)){
+                stats.count(LinkCounter::BadId);
+                return COMMAND_ID::Last;
+            }
+            if(pos + 1 + commandLen[entryId] > payload.size()){
+                stats.count(LinkCounter::BadLength);
+                return COMMAND_ID::Last;
+            }
+            pos += 1 + commandLen[entryId];
+        }
+
+        COMMAND_ID last = COMMAND_ID::Last;
+        for(pos = 1; pos < payload.size(); pos += 1 + commandLen[payload[pos]]){
+            const COMMAND_ID rid = static_cast<COMMAND_ID>(payload[pos]);
+            const COMMAND_ID res = dispatchCommand(rid, payload.subview(pos + 1, commandLen[payload[pos]]), summary, respond);
+            if(res != COMMAND_ID::Last){
+                last = res;
+            }
+        }
+        return last;
+    }
 
+    //respond: transmit what the handler returns
+    COMMAND_ID dispatchCommand(const COMMAND_ID rid, const FrameView &frameBody, ReceiveSummary &summary, bool respond){
+        frameObserver(rid, frameBody);
         //check if handler is valid
         if(commandHandlers[static_cast<uint8_t>(rid)] == nullptr){
+            stats.count(LinkCounter::NoHandler);
             return COMMAND_ID::Last;
         }
+        stats.countFrame(rid);
         const COMMAND_ID tid = commandHandlers[static_cast<uint8_t>(rid)]->onReceive(frameBody);
-        transmit(tid);
+        if(respond){
+            transmit(tid);
+        }
+        summary.frames++;
+        summary.ids |= uint32_t(1) << static_cast<uint8_t>(rid);
         return rid;
     }
+};
 
-private:
-    void resetBuffer();
+/*
+ * CommandManager with the default configuration.
+ * transmit() is defined weak in CommandManager.cpp so that the application can provide its own.
+ */
+class CommandManager : public BasicCommandManager<> {
+public:
+	CommandManager();
+	void transmit(const COMMAND_ID id) override;
 };
 
 } /* namespace command */
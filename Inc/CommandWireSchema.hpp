@@ -0,0 +1,555 @@
+/*
+ * CommandWireSchema.hpp
+ *
+ *  Created on: Feb 16, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#ifndef COMMAND_INC_COMMANDWIRESCHEMA_HPP_
+#define COMMAND_INC_COMMANDWIRESCHEMA_HPP_
+
+#include "FrameView.hpp"
+#include "CommandDataType.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <tuple>
+#include <utility>
+
+/*
+ * Encoding of ImuCompact. By default each axis is a scaled int16 of its full-scale range;
+ * define COMMAND_IMU_COMPACT_HALF=1 to send IEEE half floats instead, e.g. when the ranges are not known.
+ * Both ends must be built with the same setting.
+ */
+#ifndef COMMAND_IMU_COMPACT_HALF
+#define COMMAND_IMU_COMPACT_HALF 0
+#endif
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+namespace command {
+namespace wire {
+
+/*
+ * Field codecs.
+ * Each codec has a fixed wire size, encode(out, value) and decode(in, offset, value).
+ */
+
+// Value copied in host byte order. This is how every handler encoded its fields by hand.
+template<typename T>
+struct Scalar {
+	static constexpr uint8_t size = sizeof(T);
+
+	static void encode(uint8_t* out, const T &value){
+		std::memcpy(out, &value, size);
+	}
+	static void decode(const FrameView &in, size_t offset, T &value){
+		in.copy(offset, &value, size);
+	}
+};
+
+template<typename T, size_t N>
+struct Array {
+	static constexpr uint8_t size = sizeof(T) * N;
+
+	static void encode(uint8_t* out, const std::array<T, N> &value){
+		std::memcpy(out, value.data(), size);
+	}
+	static void decode(const FrameView &in, size_t offset, std::array<T, N> &value){
+		in.copy(offset, value.data(), size);
+	}
+};
+
+// Enum transmitted as its underlying integer U.
+template<typename E, typename U = uint8_t>
+struct Enum {
+	static constexpr uint8_t size = sizeof(U);
+
+	static void encode(uint8_t* out, const E &value){
+		const U raw = static_cast<U>(value);
+		std::memcpy(out, &raw, size);
+	}
+	static void decode(const FrameView &in, size_t offset, E &value){
+		U raw;
+		in.copy(offset, &raw, size);
+		value = static_cast<E>(raw);
+	}
+};
+
+// Upper 24 bits of a signed 32-bit value, little endian. The receiver gets value >> 8.
+struct Signed24High {
+	static constexpr uint8_t size = 3;
+
+	static void encode(uint8_t* out, const int32_t &value){
+		const uint32_t raw = static_cast<uint32_t>(value) >> 8;
+		out[0] = raw & 0xff;
+		out[1] = (raw >> 8) & 0xff;
+		out[2] = (raw >> 16) & 0xff;
+	}
+	static void decode(const FrameView &in, size_t offset, int32_t &value){
+		uint32_t raw = in[offset] | (uint32_t(in[offset+1]) << 8) | (uint32_t(in[offset+2]) << 16);
+		if(raw & 0x800000){
+			raw |= 0xff000000;
+		}
+		value = static_cast<int32_t>(raw);
+	}
+};
+
+/*
+ * Fixed-point int16 of value / fullScale, little endian. The value is a tuple of (array, full scale).
+ * Values outside +-fullScale saturate; the resolution is fullScale / 32767.
+ */
+template<size_t N>
+struct ScaledInt16 {
+	static constexpr uint8_t size = 2 * N;
+	static constexpr float LIMIT = 32767.0f;
+
+	template<typename Tuple>
+	static void encode(uint8_t* out, const Tuple &values){
+		const std::array<float, N> &value = std::get<0>(values);
+		const float gain = LIMIT / std::get<1>(values);
+		for(size_t i = 0; i < N; i++){
+			float scaled = value[i] * gain;
+			scaled = std::isnan(scaled) ? 0.0f : std::min(std::max(scaled, -LIMIT), LIMIT);
+			const uint16_t raw = static_cast<uint16_t>(static_cast<int16_t>(std::lround(scaled)));
+			out[2*i] = raw & 0xff;
+			out[2*i+1] = raw >> 8;
+		}
+	}
+	template<typename Tuple>
+	static void decode(const FrameView &in, size_t offset, const Tuple &values){
+		std::array<float, N> &value = std::get<0>(values);
+		const float step = std::get<1>(values) / LIMIT;
+		for(size_t i = 0; i < N; i++){
+			const int16_t raw = static_cast<int16_t>(in[offset + 2*i] | (in[offset + 2*i + 1] << 8));
+			value[i] = raw * step;
+		}
+	}
+};
+
+namespace detail {
+
+// float to IEEE binary16, rounding to nearest even.
+inline uint16_t floatToHalf(float value){
+	uint32_t f;
+	std::memcpy(&f, &value, sizeof(f));
+	const uint32_t sign = f & 0x80000000u;
+	f ^= sign;
+	uint16_t res;
+	if(f >= (127u + 16) << 23){
+		//overflow to infinity; NaN stays NaN
+		res = f > (255u << 23) ? 0x7e00 : 0x7c00;
+	}else if(f < (113u << 23)){
+		//subnormal or zero: adding 0.5 aligns the mantissa bits at the bottom and rounds them
+		const float magic = 0.5f;
+		float aligned;
+		std::memcpy(&aligned, &f, sizeof(aligned));
+		aligned += magic;
+		uint32_t bits;
+		std::memcpy(&bits, &aligned, sizeof(bits));
+		res = static_cast<uint16_t>(bits - (126u << 23));
+	}else{
+		const uint32_t mantissaOdd = (f >> 13) & 1;
+		f += ((15u - 127u) << 23) + 0xfff + mantissaOdd;
+		res = static_cast<uint16_t>(f >> 13);
+	}
+	return res | static_cast<uint16_t>(sign >> 16);
+}
+
+inline float halfToFloat(uint16_t half){
+	uint32_t f = uint32_t(half & 0x7fff) << 13;
+	const uint32_t exponent = f & (0x7c00u << 13);
+	f += (127u - 15u) << 23;
+	if(exponent == (0x7c00u << 13)){
+		//infinity or NaN
+		f += (128u - 16u) << 23;
+	}else if(exponent == 0){
+		//subnormal: renormalize with the FPU
+		f += 1u << 23;
+		float value;
+		std::memcpy(&value, &f, sizeof(value));
+		value -= 6.103515625e-05f; // 2^-14
+		std::memcpy(&f, &value, sizeof(f));
+	}
+	f |= uint32_t(half & 0x8000) << 16;
+	float res;
+	std::memcpy(&res, &f, sizeof(res));
+	return res;
+}
+
+} /* namespace detail */
+
+/*
+ * IEEE binary16 per element, little endian.
+ * Converted four at a time with F16C on x86, by the FPU where __fp16 is available and in software otherwise.
+ */
+template<size_t N>
+struct Half {
+	static constexpr uint8_t size = 2 * N;
+
+	static void encode(uint8_t* out, const std::array<float, N> &value){
+#if defined(__F16C__)
+		for(size_t i = 0; i < N; i += 4){
+			const size_t count = std::min<size_t>(4, N - i);
+			float lanes[4] = {};
+			std::memcpy(lanes, value.data() + i, count * sizeof(float));
+			const __m128i halves = _mm_cvtps_ph(_mm_loadu_ps(lanes), _MM_FROUND_TO_NEAREST_INT);
+			uint16_t raw[8];
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(raw), halves);
+			for(size_t k = 0; k < count; k++){
+				store(out + 2 * (i + k), raw[k]);
+			}
+		}
+#else
+		for(size_t i = 0; i < N; i++){
+			store(out + 2*i, toHalf(value[i]));
+		}
+#endif
+	}
+	static void decode(const FrameView &in, size_t offset, std::array<float, N> &value){
+#if defined(__F16C__)
+		for(size_t i = 0; i < N; i += 4){
+			const size_t count = std::min<size_t>(4, N - i);
+			uint16_t raw[8] = {};
+			for(size_t k = 0; k < count; k++){
+				raw[k] = load(in, offset + 2 * (i + k));
+			}
+			float lanes[4];
+			_mm_storeu_ps(lanes, _mm_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(raw))));
+			std::memcpy(value.data() + i, lanes, count * sizeof(float));
+		}
+#else
+		for(size_t i = 0; i < N; i++){
+			value[i] = toFloat(load(in, offset + 2*i));
+		}
+#endif
+	}
+
+private:
+	static void store(uint8_t* out, uint16_t raw){
+		out[0] = raw & 0xff;
+		out[1] = raw >> 8;
+	}
+	static uint16_t load(const FrameView &in, size_t offset){
+		return static_cast<uint16_t>(in[offset] | (in[offset + 1] << 8));
+	}
+#if !defined(__F16C__)
+	static uint16_t toHalf(float value){
+#if defined(__ARM_FP16_FORMAT_IEEE)
+		const __fp16 half = value;
+		uint16_t raw;
+		std::memcpy(&raw, &half, sizeof(raw));
+		return raw;
+#else
+		return detail::floatToHalf(value);
+#endif
+	}
+	static float toFloat(uint16_t raw){
+#if defined(__ARM_FP16_FORMAT_IEEE)
+		__fp16 half;
+		std::memcpy(&half, &raw, sizeof(half));
+		return half;
+#else
+		return detail::halfToFloat(raw);
+#endif
+	}
+#endif
+};
+
+// Single bit of a Packed word.
+template<uint8_t Shift>
+struct Flag {
+	template<typename W>
+	static void encode(W &word, bool value){
+		word |= W(value ? 1 : 0) << Shift;
+	}
+	template<typename W>
+	static void decode(W word, bool &value){
+		value = (word >> Shift) & 0b1;
+	}
+};
+
+// Unsigned bit field of Width bits of a Packed word.
+template<uint8_t Shift, uint8_t Width>
+struct BitField {
+	template<typename W, typename T>
+	static void encode(W &word, const T &value){
+		word |= (W(value) & mask<W>()) << Shift;
+	}
+	template<typename W, typename T>
+	static void decode(W word, T &value){
+		value = static_cast<T>((word >> Shift) & mask<W>());
+	}
+
+private:
+	template<typename W>
+	static constexpr W mask(){
+		return static_cast<W>((uint32_t(1) << Width) - 1);
+	}
+};
+
+enum class ByteOrder {
+	Little,
+	Big
+};
+
+// Bit fields packed into one word of type W. The value is a tuple of references, one per bit field.
+template<typename W, ByteOrder Order, typename... Bits>
+struct Packed {
+	static constexpr uint8_t size = sizeof(W);
+
+	template<typename Tuple>
+	static void encode(uint8_t* out, const Tuple &values){
+		W word = 0;
+		encodeBits(word, values, std::index_sequence_for<Bits...>());
+		for(uint8_t i = 0; i < size; i++){
+			const uint8_t shift = Order == ByteOrder::Little ? i * 8 : (size - 1 - i) * 8;
+			out[i] = static_cast<uint8_t>(word >> shift);
+		}
+	}
+	template<typename Tuple>
+	static void decode(const FrameView &in, size_t offset, const Tuple &values){
+		W word = 0;
+		for(uint8_t i = 0; i < size; i++){
+			const uint8_t shift = Order == ByteOrder::Little ? i * 8 : (size - 1 - i) * 8;
+			word |= static_cast<W>(W(in[offset + i]) << shift);
+		}
+		decodeBits(word, values, std::index_sequence_for<Bits...>());
+	}
+
+private:
+	template<typename Tuple, size_t... I>
+	static void encodeBits(W &word, const Tuple &values, std::index_sequence<I...>){
+		(Bits::encode(word, std::get<I>(values)), ...);
+	}
+	template<typename Tuple, size_t... I>
+	static void decodeBits(W word, const Tuple &values, std::index_sequence<I...>){
+		(Bits::decode(word, std::get<I>(values)), ...);
+	}
+};
+
+/*
+ * Sequence of fields laid out back to back.
+ * Offsets are constant expressions, so encode() and decode() compile to fixed-offset copies.
+ */
+template<typename... Fields>
+struct Format {
+	static constexpr uint8_t size = (Fields::size + ... + 0);
+
+	template<size_t I>
+	using Field = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+	template<size_t I>
+	static constexpr uint8_t offset(){
+		constexpr uint8_t sizes[] = {Fields::size..., 0};
+		uint8_t res = 0;
+		for(size_t i = 0; i < I; i++){
+			res += sizes[i];
+		}
+		return res;
+	}
+
+	// Returns the number of written bytes.
+	template<typename Tuple>
+	static uint8_t encode(uint8_t* out, const Tuple &values){
+		encodeFields(out, values, std::index_sequence_for<Fields...>());
+		return size;
+	}
+	template<typename Tuple>
+	static void decode(const FrameView &in, const Tuple &values){
+		decodeFields(in, values, std::index_sequence_for<Fields...>());
+	}
+
+private:
+	template<typename Tuple, size_t... I>
+	static void encodeFields(uint8_t* out, const Tuple &values, std::index_sequence<I...>){
+		(Fields::encode(out + offset<I>(), std::get<I>(values)), ...);
+	}
+	template<typename Tuple, size_t... I>
+	static void decodeFields(const FrameView &in, const Tuple &values, std::index_sequence<I...>){
+		(Fields::decode(in, offset<I>(), std::get<I>(values)), ...);
+	}
+};
+
+/*
+ * Wire schema of each CommandDataType type.
+ * Format lists the codecs in wire order and tie() binds them to the fields of a value.
+ * names are the field names in tie() order, one per bound field (an array is one field).
+ */
+template<typename T>
+struct Schema;
+
+template<>
+struct Schema<CommandDataType::SensorStatus> {
+	using Format = wire::Format<
+		Packed<uint8_t, ByteOrder::Little, Flag<5>, Flag<4>, Flag<3>, Flag<2>, Flag<1>, Flag<0>>>;
+	static constexpr std::array<const char*, 6> names = {"tof", "camera", "barometer", "magnetmeter", "imu", "gps"};
+
+	template<typename D>
+	static auto tie(D &d){
+		return std::make_tuple(std::tie(d.tof(), d.camera(), d.barometer(), d.magnetmeter(), d.imu(), d.gps()));
+	}
+};
+
+template<>
+struct Schema<CommandDataType::Coordinates> {
+	using Format = wire::Format<Scalar<double>, Scalar<double>>;
+	static constexpr std::array<const char*, 2> names = {"latitude", "longitude"};
+
+	template<typename D>
+	static auto tie(D &d){
+		return std::tie(d.latitude(), d.longitude());
+	}
+};
+
+template<>
+struct Schema<CommandDataType::Altitude> {
+	using Format = wire::Format<Scalar<int16_t>, Scalar<float>, Scalar<float>>;
+	static constexpr std::array<const char*, 3> names = {"altitude", "pressure", "temperature"};
+
+	template<typename D>
+	static auto tie(D &d){
+		return std::tie(d.altitude(), d.pressure(), d.temperature());
+	}
+};
+
+template<>
+struct Schema<CommandDataType::AbsoluteNavigation> {
+	using Format = wire::Format<Signed24High, Signed24High, Scalar<int16_t>, Scalar<int8_t>, Scalar<int8_t>>;
+	static constexpr std::array<const char*, 5> names = {"relativePositionNorth", "relativePositionEast", "headingDirection", "leftMotorPower", "rightMotorPower"};
+
+	template<typename D>
+	static auto tie(D &d){
+		return std::tie(d.relativePositionNorth(), d.relativePositionEast(), d.headingDirection(),
+		                d.leftMotorPower(), d.rightMotorPower());
+	}
+};
+
+template<>
+struct Schema<CommandDataType::RelativeNavigation> {
+	// Goal detection flags and the 13-bit ToF distance share one big endian word.
+	using Format = wire::Format<Scalar<int32_t>, Scalar<int32_t>, Scalar<int16_t>, Scalar<int8_t>, Scalar<int8_t>,
+		Packed<uint16_t, ByteOrder::Big, Flag<15>, Flag<14>, BitField<0, 13>>,
+		Scalar<int16_t>>;
+	static constexpr std::array<const char*, 9> names = {"relativePositionNorth", "relativePositionEast", "headingDirection", "leftMotorPower", "rightMotorPower",
+	                                                     "isDetectedGoalOnCamera", "isDetectedGoalOnTof", "tofDistance", "goalDirection"};
+
+	template<typename D>
+	static auto tie(D &d){
+		return std::make_tuple(std::ref(d.relativePositionNorth()), std::ref(d.relativePositionEast()),
+		                       std::ref(d.headingDirection()), std::ref(d.leftMotorPower()), std::ref(d.rightMotorPower()),
+		                       std::tie(d.isDetectedGoalOnCamera(), d.isDetectedGoalOnTof(), d.tofDistance()),
+		                       std::ref(d.goalDirection()));
+	}
+};
+
+template<>
+struct Schema<CommandDataType::ServoConfig> {
+	using Format = wire::Format<Enum<CommandDataType::ServoState>, Scalar<uint16_t>, Scalar<uint16_t>, Scalar<uint16_t>>;
+	static constexpr std::array<const char*, 4> names = {"state", "openCount", "centerCount", "closeCount"};
+
+	template<typename D>
+	static auto tie(D &d){
+		return std::tie(d.state(), d.openCount(), d.centerCount(), d.closeCount());
+	}
+};
+
+template<>
+struct Schema<CommandDataType::GPS> {
+	using Format = wire::Format<Scalar<double>, Scalar<double>, Scalar<uint8_t>>;
+	static constexpr std::array<const char*, 3> names = {"latitude", "longitude", "fixStatus"};
+
+	template<typename D>
+	static auto tie(D &d){
+		return std::tie(d.latitude(), d.longitude(), d.fixStatus());
+	}
+};
+
+template<>
+struct Schema<CommandDataType::IMU> {
+	using Format = wire::Format<Array<float, 3>, Array<float, 3>, Array<float, 3>>;
+	static constexpr std::array<const char*, 3> names = {"accel", "gyro", "magnet"};
+
+	template<typename D>
+	static auto tie(D &d){
+		return std::tie(d.accel(), d.gyro(), d.magnet());
+	}
+};
+
+/*
+ * Full-scale ranges of ImuCompact in the units of CommandDataType::IMU.
+ * Only used by the scaled int16 encoding. Both ends must use the same ranges.
+ */
+struct ImuFullScale {
+	float accel = 16.0f;
+	float gyro = 2000.0f;
+	float magnet = 4900.0f;
+};
+
+/*
+ * Compact encoding of CommandDataType::IMU, half the size of Schema<CommandDataType::IMU>.
+ */
+struct CompactImu {
+#if COMMAND_IMU_COMPACT_HALF
+	using Format = wire::Format<Half<3>, Half<3>, Half<3>>;
+	static constexpr std::array<const char*, 3> names = {"accel", "gyro", "magnet"};
+
+	template<typename D>
+	static auto tie(D &d, const ImuFullScale &){
+		return std::tie(d.accel(), d.gyro(), d.magnet());
+	}
+#else
+	using Format = wire::Format<ScaledInt16<3>, ScaledInt16<3>, ScaledInt16<3>>;
+	static constexpr std::array<const char*, 3> names = {"accel", "gyro", "magnet"};
+
+	template<typename D>
+	static auto tie(D &d, const ImuFullScale &scale){
+		return std::make_tuple(std::tie(d.accel(), scale.accel), std::tie(d.gyro(), scale.gyro),
+		                       std::tie(d.magnet(), scale.magnet));
+	}
+#endif
+};
+
+template<>
+struct Schema<CommandDataType::DecentLog> {
+	using Format = wire::Format<Scalar<int16_t>, Packed<uint8_t, ByteOrder::Little, Flag<0>, Flag<1>>, Scalar<int8_t>, Scalar<int8_t>>;
+	static constexpr std::array<const char*, 5> names = {"altitude", "isParachuteReleased", "isStabilizerDeploied", "leftMotorPower", "rightMotorPower"};
+
+	template<typename D>
+	static auto tie(D &d){
+		return std::make_tuple(std::ref(d.altitude), std::tie(d.isParachuteReleased, d.isStabilizerDeploied),
+		                       std::ref(d.leftMotorPower), std::ref(d.rightMotorPower));
+	}
+};
+
+// Body lengths are part of the protocol; changing a schema must not change them silently.
+static_assert(Schema<CommandDataType::SensorStatus>::Format::size == 1, "SensorStatus body length changed");
+static_assert(Schema<CommandDataType::Coordinates>::Format::size == 16, "Coordinates body length changed");
+static_assert(Schema<CommandDataType::Altitude>::Format::size == 10, "Altitude body length changed");
+static_assert(Schema<CommandDataType::AbsoluteNavigation>::Format::size == 10, "AbsoluteNavigation body length changed");
+static_assert(Schema<CommandDataType::RelativeNavigation>::Format::size == 16, "RelativeNavigation body length changed");
+static_assert(Schema<CommandDataType::ServoConfig>::Format::size == 7, "ServoConfig body length changed");
+static_assert(Schema<CommandDataType::GPS>::Format::size == 17, "GPS body length changed");
+static_assert(Schema<CommandDataType::IMU>::Format::size == 36, "IMU body length changed");
+static_assert(Schema<CommandDataType::DecentLog>::Format::size == 5, "DecentLog body length changed");
+static_assert(CompactImu::Format::size == 18, "ImuCompact body length changed");
+
+template<typename T>
+uint8_t encode(uint8_t* out, const T &value){
+	return Schema<T>::Format::encode(out, Schema<T>::tie(value));
+}
+
+template<typename T>
+void decode(const FrameView &in, T &value){
+	Schema<T>::Format::decode(in, Schema<T>::tie(value));
+}
+
+} /* namespace wire */
+} /* namespace command */
+
+#endif /* COMMAND_INC_COMMANDWIRESCHEMA_HPP_ */
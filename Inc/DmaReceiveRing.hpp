@@ -0,0 +1,98 @@
+/*
+ * DmaReceiveRing.hpp
+ *
+ *  Created on: Mar 6, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#ifndef COMMAND_INC_DMARECEIVERING_HPP_
+#define COMMAND_INC_DMARECEIVERING_HPP_
+
+#include "ReceiveRing.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace command {
+
+/*
+ * Receive ring filled directly by a circular UART DMA, so frames are parsed in place from the DMA memory.
+ * Start the DMA on data() with capacity() bytes, e.g. HAL_UARTEx_ReceiveToIdle_DMA(&huart, ring.data(), ring.capacity()),
+ * and report its write position with update(capacity() - NDTR) from the half-transfer, transfer-complete
+ * and idle-line interrupts. Updates must come at least every half lap to tell how far the DMA went.
+ *
+ * The DMA does not wait for the parser. When it catches up with unread data, readable() drops
+ * everything unread and counts an overrun; choose Size so that the parser keeps up between two polls.
+ * On cores with a data cache, place the manager in non-cacheable memory.
+ *
+ * Select it with
+ *   struct DmaConfig : DefaultManagerConfig { template<size_t Size> using Ring = DmaReceiveRing<Size>; };
+ */
+template<size_t Size>
+class DmaReceiveRing : public ReceiveRing<Size> {
+	using Base = ReceiveRing<Size>;
+	using Base::MASK;
+	using Base::buffer;
+	using Base::copyCursor;
+	using Base::readCursor;
+	using Base::droppedBytes;
+
+	// written by the consumer only, read from any context
+	std::atomic<uint32_t> overrunCount{0};
+
+public:
+	uint8_t* data(){
+		return buffer.data();
+	}
+
+	/*
+	 * Producer side. The DMA writes the bytes itself, so there is nothing to push or commit.
+	 */
+	template<typename _ForwardIterator>
+	size_t push(_ForwardIterator __first, _ForwardIterator __last) = delete;
+	uint8_t* writable(size_t &len) = delete;
+	void commit(size_t len) = delete;
+
+	/*
+	 * Producer side. position is the index the DMA writes next, i.e. capacity() - NDTR.
+	 */
+	void update(size_t position){
+		const uint32_t write = copyCursor.load(std::memory_order_relaxed);
+		const uint32_t advanced = (static_cast<uint32_t>(position) - write) & MASK;
+		copyCursor.store(write + advanced, std::memory_order_release);
+	}
+
+	/*
+	 * Consumer side. Once the DMA reaches the oldest unread byte it overwrites unread data,
+	 * so everything unread is dropped and parsing restarts at the next received byte.
+	 */
+	size_t readable(){
+		const uint32_t write = copyCursor.load(std::memory_order_acquire);
+		const uint32_t read = readCursor.load(std::memory_order_relaxed);
+		if(write - read >= Size){
+			overrunCount.store(overrunCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			droppedBytes.store(droppedBytes.load(std::memory_order_relaxed) + (write - read), std::memory_order_relaxed);
+			readCursor.store(write, std::memory_order_release);
+			return 0;
+		}
+		return write - read;
+	}
+
+	/*
+	 * Every byte the DMA wrote arrived, including the unread bytes dropped at an overrun.
+	 */
+	uint32_t received() const {
+		return copyCursor.load(std::memory_order_relaxed);
+	}
+
+	/*
+	 * Number of times the DMA lapped the parser.
+	 */
+	uint32_t overruns() const {
+		return overrunCount.load(std::memory_order_relaxed);
+	}
+};
+
+} /* namespace command */
+
+#endif /* COMMAND_INC_DMARECEIVERING_HPP_ */
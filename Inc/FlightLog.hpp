@@ -0,0 +1,185 @@
+/*
+ * FlightLog.hpp
+ *
+ *  Created on: Mar 11, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#ifndef COMMAND_INC_FLIGHTLOG_HPP_
+#define COMMAND_INC_FLIGHTLOG_HPP_
+
+#include "CommandHandlerBase.h"
+#include "FrameView.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace command {
+namespace flightlog {
+
+/*
+ * File format of FlightRecorder. All values are little endian (the host order of the ground station).
+ *
+ *   block 0        FileHeader
+ *   block 1...     BlockHeader, then records up to BlockHeader::committed bytes
+ *   record         int64 time (ns, CLOCK_REALTIME), uint8 COMMAND_ID, uint8 body length, body
+ *
+ * Records never cross a block, so every block is a seek point: blocks have a fixed size and their headers
+ * carry the index and time of their first record, which makes a binary search over blocks a seek index.
+ * committed is stored after the record bytes, so a record cut by a crash is never read.
+ * The blocks end at the first one without BLOCK_MAGIC.
+ */
+static constexpr size_t BLOCK_SIZE = 4096;
+static constexpr uint64_t FILE_MAGIC = 0x31474f4c444d43ULL; // "CMDLOG1"
+static constexpr uint32_t BLOCK_MAGIC = 0x4b4c4243;         // "CBLK"
+static constexpr uint32_t VERSION = 1;
+
+struct FileHeader {
+	uint64_t magic;
+	uint32_t version;
+	uint32_t blockSize;
+	int64_t createdTime;
+	uint8_t idCount; // COMMAND_ID::Last of the recorder
+	uint8_t reserved[7];
+};
+
+struct BlockHeader {
+	uint32_t magic;
+	uint32_t committed;  // bytes of complete records after this header
+	uint64_t firstIndex; // index of the first record in the whole log
+	int64_t firstTime;
+	uint32_t sequence;   // block number, starting at 0 for block 1
+	uint32_t reserved;
+};
+
+static constexpr size_t RECORD_HEADER_SIZE = 10;
+static constexpr size_t BLOCK_PAYLOAD = BLOCK_SIZE - sizeof(BlockHeader);
+
+static_assert(sizeof(FileHeader) == 32 && sizeof(BlockHeader) == 32, "flight log headers must not have padding");
+static_assert(RECORD_HEADER_SIZE + 0xff <= BLOCK_PAYLOAD, "a record must fit in a block");
+
+struct Record {
+	uint64_t index;
+	int64_t time;
+	COMMAND_ID id;
+	FrameView body;
+};
+
+/*
+ * Records of one block, in order.
+ */
+class BlockRecords {
+	const uint8_t* payload;
+	size_t committed;
+	uint64_t firstIndex;
+
+public:
+	BlockRecords(const BlockHeader* header)
+		:payload(reinterpret_cast<const uint8_t*>(header) + sizeof(BlockHeader)),
+		 committed(__atomic_load_n(&header->committed, __ATOMIC_ACQUIRE)),
+		 firstIndex(header->firstIndex){
+		if(committed > BLOCK_PAYLOAD){
+			committed = 0;
+		}
+	}
+
+	/*
+	 * Read the record at byte offset of the payload, which has index, and return the offset of the next one.
+	 * Returns 0 when there is no complete record at offset.
+	 */
+	size_t read(size_t offset, uint64_t index, Record &record) const {
+		if(offset + RECORD_HEADER_SIZE > committed){
+			return 0;
+		}
+		const uint8_t len = payload[offset + 9];
+		if(offset + RECORD_HEADER_SIZE + len > committed){
+			return 0;
+		}
+		record.index = index;
+		std::memcpy(&record.time, payload + offset, sizeof(record.time));
+		record.id = static_cast<COMMAND_ID>(payload[offset + 8]);
+		record.body = FrameView(payload + offset + RECORD_HEADER_SIZE, len);
+		return offset + RECORD_HEADER_SIZE + len;
+	}
+
+	/*
+	 * f(const Record&) returns false to stop. Returns false when it was stopped.
+	 */
+	template<typename F>
+	bool forEach(F f) const {
+		Record record;
+		uint64_t index = firstIndex;
+		for(size_t offset = 0; (offset = read(offset, index, record)) != 0; index++){
+			if(!f(record)){
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+} /* namespace flightlog */
+} /* namespace command */
+
+#if defined(__linux__)
+
+namespace command {
+
+/*
+ * Read-only view of a log written by FlightRecorder, mapped into memory.
+ * A log cut by a crash is read up to its last committed record.
+ */
+class FlightLogReader {
+	int fd = -1;
+	const uint8_t* map = nullptr;
+	size_t mapSize = 0;
+	size_t blocks = 0;
+
+public:
+	FlightLogReader() = default;
+	FlightLogReader(const FlightLogReader&) = delete;
+	FlightLogReader& operator=(const FlightLogReader&) = delete;
+	~FlightLogReader(){
+		close();
+	}
+
+	bool open(const char* path);
+	void close();
+
+	bool isOpen() const {
+		return map != nullptr;
+	}
+
+	const flightlog::FileHeader& header() const {
+		return *reinterpret_cast<const flightlog::FileHeader*>(map);
+	}
+
+	/*
+	 * Number of data blocks, up to the first one which was never started.
+	 */
+	size_t blockCount() const {
+		return blocks;
+	}
+
+	const flightlog::BlockHeader& block(size_t i) const {
+		return *reinterpret_cast<const flightlog::BlockHeader*>(map + (i + 1) * flightlog::BLOCK_SIZE);
+	}
+
+	/*
+	 * f(const flightlog::Record&) for every record from block first on; f returns false to stop.
+	 */
+	template<typename F>
+	void forEachRecord(F f, size_t first = 0) const {
+		for(size_t i = first; i < blocks; i++){
+			if(!flightlog::BlockRecords(&block(i)).forEach(f)){
+				return;
+			}
+		}
+	}
+};
+
+} /* namespace command */
+
+#endif /* __linux__ */
+
+#endif /* COMMAND_INC_FLIGHTLOG_HPP_ */
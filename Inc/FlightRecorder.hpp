@@ -0,0 +1,153 @@
+/*
+ * FlightRecorder.hpp
+ *
+ *  Created on: Mar 11, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#ifndef COMMAND_INC_FLIGHTRECORDER_HPP_
+#define COMMAND_INC_FLIGHTRECORDER_HPP_
+
+#include "FlightLog.hpp"
+#include "Callback.hpp"
+
+#if defined(__linux__)
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace command {
+
+/*
+ * Append-only log of received commands for the ground station, in the format of flightlog.
+ * Attach it to a manager to record every validated command with its receive time:
+ *   FlightRecorder recorder;
+ *   recorder.open("flight.log");
+ *   recorder.attach(manager);
+ *
+ * The file is written through a shared memory mapping of windowSize bytes, so record() is a copy into memory:
+ * it never allocates and makes no system call. A helper thread reserves the next window on disk and maps it
+ * with its pages populated while the current one fills, and unmaps the windows left behind; when the window
+ * is full, record() only switches to the prepared one. Should the helper fall behind, record() maps the window
+ * itself, counted in stalls(). The kernel owns the written pages, so a killed process loses at most the record
+ * being written; call flush() to also survive a power loss.
+ * record() is not thread safe; call it from the thread which parses.
+ */
+class FlightRecorder {
+	static constexpr size_t NO_WINDOW = SIZE_MAX;
+
+	int fd = -1;
+	uint8_t* map = nullptr;
+	size_t windowSize = 0;
+	size_t windowOffset = 0;     // file offset of map
+	size_t blockOffset = 0;      // file offset of the current block, 0 before the first record
+	size_t used = 0;             // record bytes in the current block
+	uint32_t sequence = 0;
+	uint64_t frameCount = 0;
+	uint64_t droppedCount = 0;
+	uint64_t stallCount = 0;
+	Callback<int64_t()> clock;
+	Callback<void(COMMAND_ID, const FrameView&)> next;
+
+	// shared with the helper thread under mutex
+	std::thread preparer;
+	mutable std::mutex mutex;
+	std::condition_variable wake;
+	bool stopping = false;
+	size_t wanted = NO_WINDOW;        // file offset of the window to prepare
+	uint8_t* prepared = nullptr;
+	size_t preparedOffset = 0;
+	uint8_t* retired = nullptr;       // window to unmap
+
+public:
+	static constexpr size_t DEFAULT_WINDOW = size_t(8) << 20;
+	// Windows start at multiples of their size, so any page size up to 64 KiB is aligned.
+	static constexpr size_t WINDOW_ALIGN = size_t(64) << 10;
+
+	FlightRecorder();
+	FlightRecorder(const FlightRecorder&) = delete;
+	FlightRecorder& operator=(const FlightRecorder&) = delete;
+	~FlightRecorder();
+
+	/*
+	 * Create (or truncate) path. windowSize must be a multiple of WINDOW_ALIGN.
+	 */
+	bool open(const char* path, size_t windowSize = DEFAULT_WINDOW);
+
+	/*
+	 * Trim the unused reservation and close the file. Returns false when it was not open or not trimmed.
+	 */
+	bool close();
+
+	bool isOpen() const {
+		return map != nullptr;
+	}
+
+	/*
+	 * Time source in ns for record(id, body), CLOCK_REALTIME by default.
+	 */
+	void setClock(Callback<int64_t()> clock){
+		this->clock = clock;
+	}
+
+	/*
+	 * Record every validated command of manager from now on. This replaces the frame observer of manager;
+	 * every command is passed on to next, e.g. to publish it as well.
+	 */
+	template<class Manager>
+	void attach(Manager &manager, Callback<void(COMMAND_ID, const FrameView&)> next = {}){
+		this->next = next;
+		manager.setFrameObserver(Callback<void(COMMAND_ID, const FrameView&)>::bind<&FlightRecorder::onFrame>(*this));
+	}
+
+	bool record(COMMAND_ID id, const FrameView &body){
+		return record(id, body, clock());
+	}
+
+	/*
+	 * Append one record. Returns false (and counts it as dropped) when the log is not open or full.
+	 */
+	bool record(COMMAND_ID id, const FrameView &body, int64_t time);
+
+	/*
+	 * Write the mapped window back to disk and wait for it.
+	 */
+	bool flush();
+
+	uint64_t frames() const {
+		return frameCount;
+	}
+	uint64_t dropped() const {
+		return droppedCount;
+	}
+
+	/*
+	 * Windows record() had to map itself because the helper had not prepared them yet.
+	 */
+	uint64_t stalls() const {
+		return stallCount;
+	}
+
+	/*
+	 * True when the helper has prepared the window after the current one, so filling the current one
+	 * does not stall record().
+	 */
+	bool nextWindowReady() const;
+
+private:
+	void onFrame(COMMAND_ID id, const FrameView &body){
+		record(id, body);
+		next(id, body);
+	}
+	bool startBlock(int64_t time);
+	bool switchWindow(size_t offset);
+	uint8_t* mapWindow(size_t offset);
+	void prepareWindows();
+};
+
+} /* namespace command */
+
+#endif /* __linux__ */
+
+#endif /* COMMAND_INC_FLIGHTRECORDER_HPP_ */
@@ -0,0 +1,215 @@
+/*
+ * FlightReplay.hpp
+ *
+ *  Created on: Mar 12, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#ifndef COMMAND_INC_FLIGHTREPLAY_HPP_
+#define COMMAND_INC_FLIGHTREPLAY_HPP_
+
+#include "CommandManager.h"
+#include "FlightLog.hpp"
+#include "Callback.hpp"
+
+#if defined(__linux__)
+
+#include <array>
+#include <chrono>
+#include <initializer_list>
+#include <thread>
+
+namespace command {
+
+/*
+ * Feeds a log written by FlightRecorder back through Manager::onReplayFrame(), so the registered handlers
+ * decode it and call their callbacks as during the flight. Their responses are not transmitted: a replayed
+ * Request or ConnectionCheck does not go out on the link again.
+ * Each record is serialized into a frame on the stack and validated like a received one; nothing is allocated,
+ * so replay at full speed is bound by reading the mapped log.
+ * A FlightRecorder attached to the same manager records the replayed frames again.
+ *
+ *   FlightLogReader log;
+ *   log.open("flight.log");
+ *   FlightReplay<> replay(log, manager);
+ *   replay.seekTime(launchTime);
+ *   replay.setSpeed(1.0);
+ *   replay.run();
+ */
+template<class Manager = CommandManager>
+class FlightReplay {
+	const FlightLogReader &log;
+	Manager &manager;
+	uint32_t filter = UINT32_MAX; // bit n set: replay COMMAND_ID n
+	double speed = 0;
+	// position: the record at offset of block, which has index
+	size_t block = 0;
+	size_t offset = 0;
+	uint64_t index = 0;
+	Callback<int64_t()> clock;
+	Callback<void(int64_t)> sleepUntil;
+
+	static int64_t steadyNs(){
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+	static void sleepUntilSteady(int64_t ns){
+		std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(ns)));
+	}
+
+public:
+	FlightReplay(const FlightLogReader &log, Manager &manager)
+		:log(log),manager(manager),clock(&steadyNs),sleepUntil(&sleepUntilSteady){
+		seekIndex(0);
+	}
+
+	/*
+	 * Time source in ns which paces run(), and the wait until clock() reaches a time; the steady clock by default.
+	 */
+	void setClock(Callback<int64_t()> clock, Callback<void(int64_t)> sleepUntil){
+		this->clock = clock;
+		this->sleepUntil = sleepUntil;
+	}
+
+	/*
+	 * Replay only the given commands, or every command again after clearFilter().
+	 */
+	void setFilter(std::initializer_list<COMMAND_ID> ids){
+		filter = 0;
+		for(COMMAND_ID id : ids){
+			filter |= uint32_t(1) << static_cast<uint8_t>(id);
+		}
+	}
+	void clearFilter(){
+		filter = UINT32_MAX;
+	}
+
+	/*
+	 * 0 replays as fast as possible, 1 at the recorded timing, 2 twice as fast and so on.
+	 */
+	void setSpeed(double speed){
+		this->speed = speed > 0 ? speed : 0;
+	}
+
+	/*
+	 * Index of the next record to replay.
+	 */
+	uint64_t position() const {
+		return index;
+	}
+
+	/*
+	 * Move to the record with index, or to the end when there is none. Returns false at the end.
+	 * Binary search over the block headers, then a walk inside one block.
+	 */
+	bool seekIndex(uint64_t target){
+		const size_t found = lastBlock([target](const flightlog::BlockHeader &header){
+			return header.firstIndex <= target;
+		});
+		startAt(found);
+		flightlog::Record record;
+		while(peek(record) && record.index < target){
+			advance(record);
+		}
+		return peek(record);
+	}
+
+	/*
+	 * Move to the first record received at or after time (ns, CLOCK_REALTIME). Returns false at the end.
+	 * Receive times of a log only go back if the system clock was stepped; the search assumes they do not.
+	 */
+	bool seekTime(int64_t time){
+		// the first record at or after time is in the last block which starts before it, or the one after
+		const size_t found = lastBlock([time](const flightlog::BlockHeader &header){
+			return header.firstTime < time;
+		});
+		startAt(found);
+		flightlog::Record record;
+		while(peek(record) && record.time < time){
+			advance(record);
+		}
+		return peek(record);
+	}
+
+	/*
+	 * Replay from the current position to the end, or up to maxRecords records (0 means no limit).
+	 * Records skipped by the filter are not counted. Returns the number of frames the manager dispatched.
+	 */
+	size_t run(size_t maxRecords = 0){
+		std::array<uint8_t, Manager::MAX_FRAME_LEN> frame;
+		const int64_t start = clock();
+		int64_t firstTime = 0;
+		size_t replayed = 0;
+		size_t dispatched = 0;
+		flightlog::Record record;
+		while((maxRecords == 0 || replayed < maxRecords) && peek(record)){
+			advance(record);
+			if(static_cast<uint8_t>(record.id) >= 32 || !(filter & (uint32_t(1) << static_cast<uint8_t>(record.id)))){
+				continue;
+			}
+			if(speed > 0){
+				if(replayed == 0){
+					firstTime = record.time;
+				}
+				sleepUntil(start + static_cast<int64_t>((record.time - firstTime) / speed));
+			}
+			replayed++;
+			const size_t len = Manager::constructFrameToBuffer(record.id, record.body, frame.data(), frame.size());
+			if(len > 0 && manager.onReplayFrame(FrameView(frame.data(), len)) != COMMAND_ID::Last){
+				dispatched++;
+			}
+		}
+		return dispatched;
+	}
+
+private:
+	/*
+	 * The last block for which before(header) holds, or 0. before must hold for a prefix of the blocks.
+	 */
+	template<typename Before>
+	size_t lastBlock(Before before) const {
+		size_t low = 0;
+		size_t high = log.blockCount();
+		while(low < high){
+			const size_t mid = low + (high - low) / 2;
+			if(before(log.block(mid))){
+				low = mid + 1;
+			}else{
+				high = mid;
+			}
+		}
+		return low > 0 ? low - 1 : 0;
+	}
+
+	void startAt(size_t b){
+		block = b;
+		offset = 0;
+		index = b < log.blockCount() ? log.block(b).firstIndex : 0;
+	}
+
+	/*
+	 * Read the record at the position, moving to the next block at the end of one. Returns false at the end.
+	 */
+	bool peek(flightlog::Record &record){
+		while(block < log.blockCount()){
+			if(flightlog::BlockRecords(&log.block(block)).read(offset, index, record) != 0){
+				return true;
+			}
+			if(block + 1 >= log.blockCount()){
+				return false;
+			}
+			startAt(block + 1);
+		}
+		return false;
+	}
+
+	void advance(const flightlog::Record &record){
+		offset += flightlog::RECORD_HEADER_SIZE + record.body.size();
+		index++;
+	}
+};
+
+} /* namespace command */
+
+#endif /* __linux__ */
+
+#endif /* COMMAND_INC_FLIGHTREPLAY_HPP_ */
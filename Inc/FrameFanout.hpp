@@ -0,0 +1,137 @@
+/*
+ * FrameFanout.hpp
+ *
+ *  Created on: Mar 16, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#ifndef COMMAND_INC_FRAMEFANOUT_HPP_
+#define COMMAND_INC_FRAMEFANOUT_HPP_
+
+#include "CommandManager.h"
+#include "Callback.hpp"
+
+#if defined(__linux__)
+
+#include <array>
+#include <cstdint>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace command {
+
+/*
+ * Publishes every validated command of the ground station to local processes, e.g. plotting, logging and
+ * simulation, as one datagram per command: the ID byte followed by the body.
+ *   FrameFanout fanout;
+ *   fanout.subscribeUdp(14550);
+ *   fanout.subscribeUnix("/run/cansat/plot.sock");
+ *   fanout.attach(manager);
+ *   for(;;){ ...receive...; manager.processReceiveAll(); fanout.flush(); }
+ *
+ * publish() copies the command into one of BATCH preallocated slots and never allocates or makes a system call
+ * until the batch is full; flush() sends it with one sendmmsg() per subscriber. Every subscriber has its own
+ * non-blocking connected socket, so a subscriber which does not keep up loses datagrams (counted as dropped)
+ * instead of blocking the parser or the other subscribers.
+ * A Unix socket queues at most net.unix.max_dgram_qlen datagrams (10 by default, 512 with systemd) and loses the
+ * rest of a larger batch unless it reads concurrently; use UDP, whose limit is the receive buffer, for bursts.
+ * Not thread safe; call it from the thread which parses.
+ */
+class FrameFanout {
+public:
+	static constexpr size_t MAX_SUBSCRIBERS = 16;
+	static constexpr size_t BATCH = 32;
+	static constexpr size_t MAX_DATAGRAM = 1 + 0xff;
+	static constexpr size_t NO_SUBSCRIBER = SIZE_MAX;
+
+	struct SubscriberStatistics {
+		uint64_t sent = 0;
+		uint64_t dropped = 0;
+	};
+
+private:
+	struct Subscriber {
+		int fd = -1;
+		SubscriberStatistics stats;
+	};
+
+	std::array<Subscriber, MAX_SUBSCRIBERS> subscribers;
+	std::array<std::array<uint8_t, MAX_DATAGRAM>, BATCH> slots;
+	std::array<iovec, BATCH> vectors;
+	std::array<mmsghdr, BATCH> messages;
+	size_t queued = 0;
+	uint64_t publishedCount = 0;
+	uint64_t rejectedCount = 0;
+	uint64_t sendCount = 0;
+	Callback<void(COMMAND_ID, const FrameView&)> next;
+
+public:
+	FrameFanout();
+	FrameFanout(const FrameFanout&) = delete;
+	FrameFanout& operator=(const FrameFanout&) = delete;
+	~FrameFanout();
+
+	/*
+	 * Send to 127.0.0.1:port. Returns the subscriber number, or NO_SUBSCRIBER when all are taken.
+	 */
+	size_t subscribeUdp(uint16_t port);
+
+	/*
+	 * Send to the Unix datagram socket bound to path. Returns NO_SUBSCRIBER when nothing is bound there.
+	 */
+	size_t subscribeUnix(const char* path);
+
+	void unsubscribe(size_t subscriber);
+
+	size_t subscriberCount() const;
+
+	/*
+	 * Publish every validated command of manager from now on. This replaces the frame observer of manager;
+	 * every command is passed on to next, e.g. to record it as well.
+	 */
+	template<class Manager>
+	void attach(Manager &manager, Callback<void(COMMAND_ID, const FrameView&)> next = {}){
+		this->next = next;
+		manager.setFrameObserver(Callback<void(COMMAND_ID, const FrameView&)>::bind<&FrameFanout::onFrame>(*this));
+	}
+
+	/*
+	 * Queue one command and flush() when the batch is full. Returns false when the body does not fit a datagram.
+	 */
+	bool publish(COMMAND_ID id, const FrameView &body);
+
+	/*
+	 * Send the queued commands to every subscriber. Returns the number of datagrams sent.
+	 */
+	size_t flush();
+
+	size_t pending() const {
+		return queued;
+	}
+	uint64_t published() const {
+		return publishedCount;
+	}
+	uint64_t rejected() const {
+		return rejectedCount;
+	}
+	// sendmmsg() calls so far
+	uint64_t sends() const {
+		return sendCount;
+	}
+	SubscriberStatistics statistics(size_t subscriber) const {
+		return subscribers[subscriber].stats;
+	}
+
+private:
+	void onFrame(COMMAND_ID id, const FrameView &body){
+		publish(id, body);
+		next(id, body);
+	}
+	size_t connectSocket(int family, const sockaddr* address, socklen_t len);
+};
+
+} /* namespace command */
+
+#endif /* __linux__ */
+
+#endif /* COMMAND_INC_FRAMEFANOUT_HPP_ */
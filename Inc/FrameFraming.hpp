@@ -0,0 +1,184 @@
+/*
+ * FrameFraming.hpp
+ *
+ *  Created on: Feb 26, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#ifndef COMMAND_INC_FRAMEFRAMING_HPP_
+#define COMMAND_INC_FRAMEFRAMING_HPP_
+
+#include "FrameView.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace command {
+namespace framing {
+
+/*
+ * Framings selectable with the Framing member of the manager configuration.
+ * A framing wraps the raw frame (ID + body + integrity check) for the wire and finds frames in the receive ring.
+ * Each framing provides
+ *   overhead                                  bytes added to the raw frame
+ *   maxRawLen                                 longest raw frame it can wrap
+ *   finish(frame, rawLen)                     wrap the raw frame stored at frame + 1 in place, return the wire length
+ *   unwrap(frame, scratch, capacity, raw)     validate a wire frame and return its raw frame
+ *   scan(ring, readable, budget, frameLen, maxFrameLen)
+ *                                             find the next wire frame at the read position of ring
+ * frameLen(id, next) returns the wire length of a frame of id, or 0 when id is not valid;
+ * next is the byte after the ID (the length of a superframe),
+ * and maxFrameLen is the wire length of the longest frame.
+ */
+
+/*
+ * Result of scan().
+ */
+struct Scan {
+	enum class Action {
+		Frame, // a complete wire frame of len bytes starts at the read position
+		Skip,  // len bytes can not start a frame
+		Wait   // more bytes are needed
+	};
+	enum class Reject {
+		None,   // noise or a partial frame
+		BadId,  // a frame start followed by an ID which is not valid
+		Framing // a frame start without its stop byte, or a frame longer than any ID
+	};
+	Action action;
+	size_t len;
+	Reject reject = Reject::None; // why a Skip was returned
+};
+
+/*
+ * START_BYTE, raw frame, STOP_BYTE. The original frame format.
+ * Frame boundaries are found from the length of each ID, so bytes equal to START_BYTE inside a body
+ * cause false starts which are rejected one byte at a time.
+ */
+struct Delimited {
+	static constexpr uint8_t START_BYTE = 's';
+	static constexpr uint8_t STOP_BYTE = 'e';
+	static constexpr uint8_t overhead = 2;
+	static constexpr size_t maxRawLen = 0xff - overhead;
+
+	static size_t finish(uint8_t* frame, size_t rawLen){
+		frame[0] = START_BYTE;
+		frame[rawLen + 1] = STOP_BYTE;
+		return rawLen + overhead;
+	}
+
+	// The raw frame is a view into frame; scratch is not used.
+	static bool unwrap(const FrameView &frame, uint8_t* /*scratch*/, size_t /*capacity*/, FrameView &raw){
+		if(frame.size() < overhead || frame[0] != START_BYTE || frame[frame.size()-1] != STOP_BYTE){
+			return false;
+		}
+		raw = frame.subview(1, frame.size() - overhead);
+		return true;
+	}
+
+	template<typename Ring, typename FrameLen>
+	static Scan scan(const Ring &ring, size_t readable, size_t budget, FrameLen frameLen, size_t /*maxFrameLen*/){
+		if(readable < 3){
+			return {Scan::Action::Wait, 0};
+		}
+		if(ring.peek(0) != START_BYTE){
+			return {Scan::Action::Skip, ring.find(START_BYTE, 0, std::min(readable - 1, budget))};
+		}
+		const size_t len = frameLen(ring.peek(1), ring.peek(2));
+		if(len == 0){
+			//There is no valid id for possibleId.
+			return {Scan::Action::Skip, 1, Scan::Reject::BadId};
+		}
+		if(readable < len){
+			//Wait for next receive.
+			return {Scan::Action::Wait, 0};
+		}
+		if(ring.peek(len - 1) != STOP_BYTE){
+			return {Scan::Action::Skip, 1, Scan::Reject::Framing};
+		}
+		return {Scan::Action::Frame, len};
+	}
+};
+
+/*
+ * Consistent Overhead Byte Stuffing of the raw frame followed by a zero delimiter.
+ * Zero never appears inside an encoded frame, so the next frame always starts after the next zero
+ * and resynchronization is a single delimiter search regardless of the payload.
+ * Raw frames are at most 254 bytes, so encoding adds exactly one code byte and the overhead equals Delimited.
+ */
+struct Cobs {
+	static constexpr uint8_t DELIMITER = 0x00;
+	static constexpr uint8_t overhead = 2;
+	static constexpr size_t maxRawLen = 0xfe;
+
+	/*
+	 * Encode in place in one pass: every zero is replaced with the distance to the next zero,
+	 * and frame[0] holds the distance to the first one.
+	 */
+	static size_t finish(uint8_t* frame, size_t rawLen){
+		size_t code = 0;
+		for(size_t i = 1; i <= rawLen; i++){
+			if(frame[i] == DELIMITER){
+				frame[code] = static_cast<uint8_t>(i - code);
+				code = i;
+			}
+		}
+		frame[code] = static_cast<uint8_t>(rawLen + 1 - code);
+		frame[rawLen + 1] = DELIMITER;
+		return rawLen + overhead;
+	}
+
+	// The raw frame is decoded into scratch, so it is always contiguous.
+	static bool unwrap(const FrameView &frame, uint8_t* scratch, size_t capacity, FrameView &raw){
+		if(frame.size() < overhead || frame[frame.size()-1] != DELIMITER || frame.size() - overhead > capacity){
+			return false;
+		}
+		const size_t encodedLen = frame.size() - 1;
+		size_t in = 0;
+		size_t out = 0;
+		while(in < encodedLen){
+			const uint8_t code = frame[in++];
+			if(code == DELIMITER || in + code - 1 > encodedLen){
+				return false;
+			}
+			for(uint8_t i = 1; i < code; i++){
+				const uint8_t value = frame[in++];
+				if(value == DELIMITER){
+					return false;
+				}
+				scratch[out++] = value;
+			}
+			if(code != 0xff && in < encodedLen){
+				scratch[out++] = DELIMITER;
+			}
+		}
+		raw = FrameView(scratch, out);
+		return true;
+	}
+
+	// Everything up to the next delimiter is one frame, so the ID is not needed to find it.
+	template<typename Ring, typename FrameLen>
+	static Scan scan(const Ring &ring, size_t readable, size_t budget, FrameLen /*frameLen*/, size_t maxFrameLen){
+		const size_t delimiter = ring.find(DELIMITER, 0, readable);
+		if(delimiter == readable){
+			if(readable < maxFrameLen){
+				return {Scan::Action::Wait, 0};
+			}
+			// Already too long to be a frame. The rest of it is rejected when its delimiter arrives.
+			return {Scan::Action::Skip, std::min(readable, budget), Scan::Reject::Framing};
+		}
+		if(delimiter == 0){
+			// Empty frame, e.g. a delimiter sent to flush the receiver.
+			return {Scan::Action::Skip, 1};
+		}
+		if(delimiter >= maxFrameLen){
+			return {Scan::Action::Skip, std::min(delimiter + 1, budget), Scan::Reject::Framing};
+		}
+		return {Scan::Action::Frame, delimiter + 1};
+	}
+};
+
+} /* namespace framing */
+} /* namespace command */
+
+#endif /* COMMAND_INC_FRAMEFRAMING_HPP_ */
@@ -0,0 +1,245 @@
+/*
+ * FrameIntegrity.hpp
+ *
+ *  Created on: Feb 24, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#ifndef COMMAND_INC_FRAMEINTEGRITY_HPP_
+#define COMMAND_INC_FRAMEINTEGRITY_HPP_
+
+#include "FrameView.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/*
+ * CRC-32C uses the CPU instruction when available: SSE4.2 on x86-64 (checked at run time)
+ * and the ARMv8 CRC extension (checked at compile time).
+ * Define COMMAND_CRC_USE_HARDWARE=0 to always use the tables.
+ */
+#ifndef COMMAND_CRC_USE_HARDWARE
+#define COMMAND_CRC_USE_HARDWARE 1
+#endif
+
+#if COMMAND_CRC_USE_HARDWARE && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define COMMAND_CRC32C_X86 1
+#include <nmmintrin.h>
+#elif COMMAND_CRC_USE_HARDWARE && defined(__ARM_FEATURE_CRC32)
+#define COMMAND_CRC32C_ARM 1
+#include <arm_acle.h>
+#endif
+
+namespace command {
+namespace integrity {
+
+/*
+ * Integrity checks selectable with the Integrity member of the manager configuration.
+ * Each check covers ID and body of a frame and provides
+ *   value_type, size, init(), update(crc, data, len), finalize(crc), store(out, value) and load(in, offset).
+ * The check value is transmitted little endian.
+ */
+
+template<typename T>
+struct CheckValue {
+	using value_type = T;
+	static constexpr uint8_t size = sizeof(T);
+
+	static void store(uint8_t* out, T value){
+		for(uint8_t i = 0; i < size; i++){
+			out[i] = static_cast<uint8_t>(value >> (8 * i));
+		}
+	}
+	static T load(const FrameView &in, size_t offset){
+		T value = 0;
+		for(uint8_t i = 0; i < size; i++){
+			value |= static_cast<T>(T(in[offset + i]) << (8 * i));
+		}
+		return value;
+	}
+};
+
+// 8-bit additive sum. The original frame format.
+struct Sum8 : CheckValue<uint8_t> {
+	static constexpr uint8_t init(){
+		return 0;
+	}
+	static uint8_t update(uint8_t sum, const uint8_t* data, size_t len){
+		for(size_t i = 0; i < len; i++){
+			sum += data[i];
+		}
+		return sum;
+	}
+	static constexpr uint8_t finalize(uint8_t sum){
+		return sum;
+	}
+};
+
+namespace detail {
+
+constexpr std::array<uint8_t, 256> makeCrc8Table(uint8_t poly){
+	std::array<uint8_t, 256> table = {};
+	for(uint16_t i = 0; i < 256; i++){
+		uint8_t crc = i;
+		for(uint8_t bit = 0; bit < 8; bit++){
+			crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ poly) : static_cast<uint8_t>(crc << 1);
+		}
+		table[i] = crc;
+	}
+	return table;
+}
+
+constexpr std::array<uint16_t, 256> makeCrc16Table(uint16_t poly){
+	std::array<uint16_t, 256> table = {};
+	for(uint16_t i = 0; i < 256; i++){
+		uint16_t crc = i << 8;
+		for(uint8_t bit = 0; bit < 8; bit++){
+			crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ poly) : static_cast<uint16_t>(crc << 1);
+		}
+		table[i] = crc;
+	}
+	return table;
+}
+
+// Reflected CRC-32 tables for slicing-by-4. Table k advances a byte by k further bytes.
+constexpr std::array<std::array<uint32_t, 256>, 4> makeCrc32Tables(uint32_t poly){
+	std::array<std::array<uint32_t, 256>, 4> tables = {};
+	for(uint16_t i = 0; i < 256; i++){
+		uint32_t crc = i;
+		for(uint8_t bit = 0; bit < 8; bit++){
+			crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+		}
+		tables[0][i] = crc;
+	}
+	for(uint16_t i = 0; i < 256; i++){
+		for(uint8_t k = 1; k < 4; k++){
+			tables[k][i] = (tables[k-1][i] >> 8) ^ tables[0][tables[k-1][i] & 0xff];
+		}
+	}
+	return tables;
+}
+
+} /* namespace detail */
+
+// CRC-8/SMBUS: poly 0x07, init 0x00.
+struct Crc8 : CheckValue<uint8_t> {
+	static constexpr std::array<uint8_t, 256> table = detail::makeCrc8Table(0x07);
+
+	static constexpr uint8_t init(){
+		return 0x00;
+	}
+	static uint8_t update(uint8_t crc, const uint8_t* data, size_t len){
+		for(size_t i = 0; i < len; i++){
+			crc = table[crc ^ data[i]];
+		}
+		return crc;
+	}
+	static constexpr uint8_t finalize(uint8_t crc){
+		return crc;
+	}
+};
+
+// CRC-16/CCITT-FALSE: poly 0x1021, init 0xFFFF, not reflected.
+struct Crc16Ccitt : CheckValue<uint16_t> {
+	static constexpr std::array<uint16_t, 256> table = detail::makeCrc16Table(0x1021);
+
+	static constexpr uint16_t init(){
+		return 0xFFFF;
+	}
+	static uint16_t update(uint16_t crc, const uint8_t* data, size_t len){
+		for(size_t i = 0; i < len; i++){
+			crc = static_cast<uint16_t>(crc << 8) ^ table[(crc >> 8) ^ data[i]];
+		}
+		return crc;
+	}
+	static constexpr uint16_t finalize(uint16_t crc){
+		return crc;
+	}
+};
+
+// CRC-32C (Castagnoli): reflected poly 0x82F63B78, init and final xor 0xFFFFFFFF.
+struct Crc32c : CheckValue<uint32_t> {
+	static constexpr std::array<std::array<uint32_t, 256>, 4> tables = detail::makeCrc32Tables(0x82F63B78);
+
+	static constexpr uint32_t init(){
+		return 0xFFFFFFFF;
+	}
+	static uint32_t update(uint32_t crc, const uint8_t* data, size_t len){
+#if defined(COMMAND_CRC32C_X86)
+		if(hasHardware()){
+			return updateHardware(crc, data, len);
+		}
+#elif defined(COMMAND_CRC32C_ARM)
+		return updateHardware(crc, data, len);
+#endif
+		return updateTable(crc, data, len);
+	}
+	static constexpr uint32_t finalize(uint32_t crc){
+		return ~crc;
+	}
+
+	// Slicing-by-4.
+	static uint32_t updateTable(uint32_t crc, const uint8_t* data, size_t len){
+		for(; len >= 4; len -= 4, data += 4){
+			crc ^= uint32_t(data[0]) | (uint32_t(data[1]) << 8) | (uint32_t(data[2]) << 16) | (uint32_t(data[3]) << 24);
+			crc = tables[3][crc & 0xff] ^ tables[2][(crc >> 8) & 0xff] ^ tables[1][(crc >> 16) & 0xff] ^ tables[0][crc >> 24];
+		}
+		for(; len > 0; len--, data++){
+			crc = (crc >> 8) ^ tables[0][(crc ^ *data) & 0xff];
+		}
+		return crc;
+	}
+
+#if defined(COMMAND_CRC32C_X86)
+	static bool hasHardware(){
+		static const bool has = __builtin_cpu_supports("sse4.2");
+		return has;
+	}
+
+	__attribute__((target("sse4.2")))
+	static uint32_t updateHardware(uint32_t crc, const uint8_t* data, size_t len){
+		uint64_t crc64 = crc;
+		for(; len >= 8; len -= 8, data += 8){
+			uint64_t word;
+			std::memcpy(&word, data, sizeof(word));
+			crc64 = _mm_crc32_u64(crc64, word);
+		}
+		crc = static_cast<uint32_t>(crc64);
+		for(; len > 0; len--, data++){
+			crc = _mm_crc32_u8(crc, *data);
+		}
+		return crc;
+	}
+#elif defined(COMMAND_CRC32C_ARM)
+	static uint32_t updateHardware(uint32_t crc, const uint8_t* data, size_t len){
+		for(; len >= 4; len -= 4, data += 4){
+			uint32_t word;
+			std::memcpy(&word, data, sizeof(word));
+			crc = __crc32cw(crc, word);
+		}
+		for(; len > 0; len--, data++){
+			crc = __crc32cb(crc, *data);
+		}
+		return crc;
+	}
+#endif
+};
+
+/*
+ * Compute the check of a (possibly two-segment) view.
+ */
+template<typename Integrity>
+typename Integrity::value_type compute(const FrameView &view){
+	auto value = Integrity::init();
+	value = Integrity::update(value, view.headData(), view.headSize());
+	if(view.tailSize() > 0){
+		value = Integrity::update(value, view.tailData(), view.tailSize());
+	}
+	return Integrity::finalize(value);
+}
+
+} /* namespace integrity */
+} /* namespace command */
+
+#endif /* COMMAND_INC_FRAMEINTEGRITY_HPP_ */
@@ -0,0 +1,81 @@
+/*
+ * FrameView.hpp
+ *
+ *  Created on: Feb 12, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#ifndef COMMAND_INC_FRAMEVIEW_HPP_
+#define COMMAND_INC_FRAMEVIEW_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace command {
+
+/*
+ * Non-owning view of received bytes.
+ * A frame which wraps around the end of a ring buffer is described by two segments,
+ * so handlers can decode straight out of the receive buffer without copying it first.
+ */
+class FrameView {
+	const uint8_t* head = nullptr;
+	const uint8_t* tail = nullptr;
+	size_t headLen = 0;
+	size_t tailLen = 0;
+
+public:
+	constexpr FrameView() = default;
+	constexpr FrameView(const uint8_t* data, size_t len)
+		: head(data), headLen(len){}
+	constexpr FrameView(const uint8_t* head, size_t headLen, const uint8_t* tail, size_t tailLen)
+		: head(head), tail(tail), headLen(headLen), tailLen(tailLen){}
+
+	constexpr size_t size() const { return headLen + tailLen; }
+	constexpr bool empty() const { return size() == 0; }
+	constexpr bool contiguous() const { return tailLen == 0; }
+
+	const uint8_t* headData() const { return head; }
+	size_t headSize() const { return headLen; }
+	const uint8_t* tailData() const { return tail; }
+	size_t tailSize() const { return tailLen; }
+
+	uint8_t operator[](size_t i) const {
+		return i < headLen ? head[i] : tail[i - headLen];
+	}
+
+	FrameView subview(size_t offset, size_t len) const {
+		if(offset >= headLen){
+			return FrameView(tail + (offset - headLen), len);
+		}
+		const size_t first = headLen - offset;
+		if(len <= first){
+			return FrameView(head + offset, len);
+		}
+		return FrameView(head + offset, first, tail, len - first);
+	}
+
+	/*
+	 * Copy len bytes starting at offset into dest.
+	 */
+	void copy(size_t offset, void* dest, size_t len) const {
+		uint8_t* out = static_cast<uint8_t*>(dest);
+		if(offset < headLen){
+			const size_t first = headLen - offset < len ? headLen - offset : len;
+			std::memcpy(out, head + offset, first);
+			out += first;
+			len -= first;
+			offset = 0;
+		}else{
+			offset -= headLen;
+		}
+		if(len > 0){
+			std::memcpy(out, tail + offset, len);
+		}
+	}
+};
+
+} /* namespace command */
+
+#endif /* COMMAND_INC_FRAMEVIEW_HPP_ */
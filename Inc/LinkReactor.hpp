@@ -0,0 +1,237 @@
+/*
+ * LinkReactor.hpp
+ *
+ *  Created on: Mar 14, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#ifndef COMMAND_INC_LINKREACTOR_HPP_
+#define COMMAND_INC_LINKREACTOR_HPP_
+
+#include "CommandManager.h"
+#include "Callback.hpp"
+
+#if defined(__linux__)
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <fcntl.h>
+#include <memory>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace command {
+
+/*
+ * Event loop of a ground station which receives from many links at once: serial ports, ptys, sockets.
+ * Every link has its own manager, so its own receive ring, statistics and handlers, which hold the data
+ * of one vehicle. The decode code of the handlers is shared; only the decoded data is per link.
+ *
+ *   struct Vehicle { BasicCommandManager<GroundConfig> manager; Altitude altitude; Imu imu; };
+ *   LinkReactor<BasicCommandManager<GroundConfig>> reactor(2);
+ *   reactor.add(radioFd, vehicleA.manager);
+ *   reactor.add(relayFd, vehicleB.manager);
+ *   reactor.start();
+ *
+ * Links are spread round robin over shards of one epoll set each. start() runs every shard on its own thread,
+ * so a link is always read, parsed and dispatched by one thread and its manager needs no locking; only handlers
+ * of links on different shards run concurrently. Without start(), poll() runs a shard on the calling thread.
+ *
+ * Bytes are read straight into the free space of the receive ring, so the ring never overflows: what does not fit
+ * stays in the kernel until the parser made room. A wakeup reads at most READ_BUDGET bytes of a link, so a busy
+ * link can not starve the others of its shard.
+ */
+template<class Manager = CommandManager>
+class LinkReactor {
+public:
+	static constexpr size_t READ_BUDGET = 64 * 1024;
+	static constexpr size_t NO_LINK = SIZE_MAX;
+
+private:
+	struct Link {
+		int fd;
+		Manager* manager;
+		size_t shard;
+		std::atomic<bool> open{true};
+	};
+	struct Shard {
+		int epoll = -1;
+		int wake = -1; // eventfd which interrupts epoll_wait() on stop()
+		std::thread thread;
+	};
+
+	std::vector<std::unique_ptr<Link>> links;
+	std::vector<Shard> shards;
+	std::atomic<bool> running{false};
+	Callback<void(size_t)> closed;
+
+public:
+	explicit LinkReactor(size_t shardCount = 1):shards(shardCount > 0 ? shardCount : 1){
+		for(Shard &shard : shards){
+			shard.epoll = epoll_create1(EPOLL_CLOEXEC);
+			shard.wake = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+			epoll_event event = {};
+			event.events = EPOLLIN;
+			event.data.u64 = NO_LINK;
+			if(shard.epoll >= 0 && shard.wake >= 0){
+				epoll_ctl(shard.epoll, EPOLL_CTL_ADD, shard.wake, &event);
+			}
+		}
+	}
+	LinkReactor(const LinkReactor&) = delete;
+	LinkReactor& operator=(const LinkReactor&) = delete;
+	~LinkReactor(){
+		stop();
+		for(Shard &shard : shards){
+			if(shard.epoll >= 0){
+				::close(shard.epoll);
+			}
+			if(shard.wake >= 0){
+				::close(shard.wake);
+			}
+		}
+	}
+
+	/*
+	 * Receive from fd into manager. fd is made non-blocking and is not closed by the reactor.
+	 * Links are added before start(). Returns the link number, or NO_LINK on failure.
+	 */
+	size_t add(int fd, Manager &manager){
+		if(running.load(std::memory_order_relaxed) || fd < 0){
+			return NO_LINK;
+		}
+		const size_t index = links.size();
+		const size_t shard = index % shards.size();
+		const int flags = fcntl(fd, F_GETFL);
+		if(shards[shard].epoll < 0 || flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0){
+			return NO_LINK;
+		}
+		epoll_event event = {};
+		event.events = EPOLLIN;
+		event.data.u64 = index;
+		if(epoll_ctl(shards[shard].epoll, EPOLL_CTL_ADD, fd, &event) != 0){
+			return NO_LINK;
+		}
+		links.emplace_back(new Link{fd, &manager, shard});
+		return index;
+	}
+
+	/*
+	 * closed(link) is called on the thread of its shard when a link reached end of file or failed.
+	 * The link is no longer serviced; its manager can be read once the reactor stopped.
+	 */
+	void setClosedHandler(Callback<void(size_t)> closed){
+		this->closed = closed;
+	}
+
+	size_t linkCount() const {
+		return links.size();
+	}
+	size_t shardCount() const {
+		return shards.size();
+	}
+	bool isOpen(size_t link) const {
+		return links[link]->open.load(std::memory_order_acquire);
+	}
+	Manager& manager(size_t link){
+		return *links[link]->manager;
+	}
+
+	/*
+	 * Run every shard on its own thread until stop().
+	 */
+	bool start(){
+		if(running.exchange(true)){
+			return false;
+		}
+		for(size_t i = 0; i < shards.size(); i++){
+			shards[i].thread = std::thread([this, i](){
+				while(running.load(std::memory_order_acquire)){
+					poll(i, -1);
+				}
+			});
+		}
+		return true;
+	}
+
+	void stop(){
+		if(!running.exchange(false)){
+			return;
+		}
+		for(Shard &shard : shards){
+			const uint64_t one = 1;
+			if(write(shard.wake, &one, sizeof(one)) != sizeof(one)){
+				//the counter is already set, so the shard wakes up anyway
+			}
+		}
+		for(Shard &shard : shards){
+			shard.thread.join();
+		}
+	}
+
+	/*
+	 * Wait up to timeoutMs (-1 forever) for the links of shard and service the ready ones.
+	 * Returns the number of dispatched commands.
+	 */
+	size_t poll(size_t shard, int timeoutMs){
+		epoll_event events[32];
+		const int ready = epoll_wait(shards[shard].epoll, events, 32, timeoutMs);
+		size_t frames = 0;
+		for(int i = 0; i < ready; i++){
+			if(events[i].data.u64 == NO_LINK){
+				uint64_t count;
+				if(read(shards[shard].wake, &count, sizeof(count)) != sizeof(count)){
+					//already cleared
+				}
+				continue;
+			}
+			frames += service(events[i].data.u64);
+		}
+		return frames;
+	}
+
+private:
+	size_t service(size_t index){
+		Link &link = *links[index];
+		typename Manager::Ring &ring = link.manager->receiveRing();
+		size_t frames = 0;
+		size_t budget = READ_BUDGET;
+		bool open = true;
+		while(budget > 0){
+			// the parser only leaves an unfinished frame behind, so there is room (rxCapacity >= 2 frames);
+			// a read of 0 bytes would look like end of file
+			size_t space = 0;
+			uint8_t* dest = ring.writable(space);
+			if(space == 0){
+				break;
+			}
+			const ssize_t len = read(link.fd, dest, std::min(space, budget));
+			if(len > 0){
+				ring.commit(static_cast<size_t>(len));
+				budget -= static_cast<size_t>(len);
+				frames += link.manager->processReceiveAll().frames;
+			}else if(len < 0 && errno == EINTR){
+				continue;
+			}else{
+				open = len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+				break;
+			}
+		}
+		if(!open){
+			epoll_ctl(shards[link.shard].epoll, EPOLL_CTL_DEL, link.fd, nullptr);
+			link.open.store(false, std::memory_order_release);
+			closed(index);
+		}
+		return frames;
+	}
+};
+
+} /* namespace command */
+
+#endif /* __linux__ */
+
+#endif /* COMMAND_INC_LINKREACTOR_HPP_ */
@@ -0,0 +1,123 @@
+/*
+ * LinkStatistics.hpp
+ *
+ *  Created on: Mar 9, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#ifndef COMMAND_INC_LINKSTATISTICS_HPP_
+#define COMMAND_INC_LINKSTATISTICS_HPP_
+
+#include "CommandHandlerBase.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace command {
+
+enum class LinkCounter : uint8_t {
+	BytesIn = 0,  // bytes which arrived at the receive ring
+	RingOverflow, // bytes lost because the receive ring was full or lapped by the DMA
+	SkippedBytes, // bytes discarded while searching for a frame
+	BadFraming,   // wrong stop byte or broken COBS encoding
+	BadChecksum,
+	BadId,
+	BadLength,    // body length does not match the ID, or a malformed superframe
+	NoHandler,
+	Last
+};
+
+/*
+ * Counters since the last reset.
+ */
+struct LinkStatistics {
+	std::array<uint32_t, static_cast<uint8_t>(LinkCounter::Last)> counters = {};
+	std::array<uint32_t, static_cast<uint8_t>(COMMAND_ID::Last)> frames = {}; // frames dispatched per COMMAND_ID
+
+	uint32_t operator[](LinkCounter counter) const {
+		return counters[static_cast<uint8_t>(counter)];
+	}
+	uint32_t framesOf(COMMAND_ID id) const {
+		return frames[static_cast<uint8_t>(id)];
+	}
+};
+
+namespace statistics {
+
+/*
+ * Statistics selectable with the Statistics member of the manager configuration.
+ * count()/countFrame() are called by the parser. bytesIn and ringOverflow are totals kept by the receive ring
+ * and are passed to snapshot() and reset().
+ */
+
+// Disabled. Every call is an empty inline function.
+struct Null {
+	void count(LinkCounter, uint32_t = 1){
+	}
+	void countFrame(COMMAND_ID){
+	}
+	LinkStatistics snapshot(uint32_t, uint32_t) const {
+		return LinkStatistics();
+	}
+	void reset(uint32_t, uint32_t){
+	}
+};
+
+/*
+ * Always-on counters.
+ * Every counter is only written by the parser, so it is updated with a relaxed load and store
+ * instead of a read-modify-write, which also works on cores without atomic instructions (Cortex-M0).
+ * snapshot() may run in another context or thread while parsing goes on.
+ * reset() does not touch the counters; it records a baseline which snapshot() subtracts,
+ * so snapshot() and reset() must be called from one context.
+ */
+class Counting {
+	std::array<std::atomic<uint32_t>, static_cast<uint8_t>(LinkCounter::Last)> counters = {};
+	std::array<std::atomic<uint32_t>, static_cast<uint8_t>(COMMAND_ID::Last)> frames = {};
+	LinkStatistics baseline;
+
+	static void add(std::atomic<uint32_t> &counter, uint32_t n){
+		counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+	}
+
+	LinkStatistics total(uint32_t bytesIn, uint32_t ringOverflow) const {
+		LinkStatistics res;
+		for(uint8_t i = 0; i < res.counters.size(); i++){
+			res.counters[i] = counters[i].load(std::memory_order_relaxed);
+		}
+		for(uint8_t i = 0; i < res.frames.size(); i++){
+			res.frames[i] = frames[i].load(std::memory_order_relaxed);
+		}
+		res.counters[static_cast<uint8_t>(LinkCounter::BytesIn)] = bytesIn;
+		res.counters[static_cast<uint8_t>(LinkCounter::RingOverflow)] = ringOverflow;
+		return res;
+	}
+
+public:
+	void count(LinkCounter counter, uint32_t n = 1){
+		add(counters[static_cast<uint8_t>(counter)], n);
+	}
+	void countFrame(COMMAND_ID id){
+		add(frames[static_cast<uint8_t>(id)], 1);
+	}
+
+	LinkStatistics snapshot(uint32_t bytesIn, uint32_t ringOverflow) const {
+		LinkStatistics res = total(bytesIn, ringOverflow);
+		for(uint8_t i = 0; i < res.counters.size(); i++){
+			res.counters[i] -= baseline.counters[i];
+		}
+		for(uint8_t i = 0; i < res.frames.size(); i++){
+			res.frames[i] -= baseline.frames[i];
+		}
+		return res;
+	}
+
+	void reset(uint32_t bytesIn, uint32_t ringOverflow){
+		baseline = total(bytesIn, ringOverflow);
+	}
+};
+
+} /* namespace statistics */
+} /* namespace command */
+
+#endif /* COMMAND_INC_LINKSTATISTICS_HPP_ */
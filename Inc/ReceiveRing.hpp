@@ -0,0 +1,164 @@
+/*
+ * ReceiveRing.hpp
+ *
+ *  Created on: Feb 20, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#ifndef COMMAND_INC_RECEIVERING_HPP_
+#define COMMAND_INC_RECEIVERING_HPP_
+
+#include "FrameView.hpp"
+#include <array>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+/*
+ * Resynchronization uses memchr() to find the next START_BYTE or COBS delimiter.
+ * libc implementations are vectorized (SSE2/AVX2 on glibc, word-at-a-time on newlib),
+ * define COMMAND_RESYNC_USE_MEMCHR=0 to use the byte-by-byte scan instead.
+ */
+#ifndef COMMAND_RESYNC_USE_MEMCHR
+#define COMMAND_RESYNC_USE_MEMCHR 1
+#endif
+
+namespace command {
+
+/*
+ * Single-producer/single-consumer byte ring.
+ * push() may run in an interrupt handler while the main loop reads with peek()/view()/consume().
+ * Each side only writes its own cursor and publishes it with a release store,
+ * so no critical section is needed on either side.
+ * Cursors run freely and are masked on access, so all Size bytes are usable and no modulo is needed.
+ */
+template<size_t Size>
+class ReceiveRing {
+	static_assert(Size > 0 && (Size & (Size - 1)) == 0, "ReceiveRing size must be a power of two");
+	static_assert(Size <= (size_t(1) << 31), "ReceiveRing size out of range");
+	static_assert(std::atomic<uint32_t>::is_always_lock_free, "ReceiveRing needs lock-free 32-bit atomics");
+
+protected:
+	static constexpr uint32_t MASK = Size - 1;
+
+	std::array<uint8_t, Size> buffer = {};
+	std::atomic<uint32_t> copyCursor{0};
+	std::atomic<uint32_t> readCursor{0};
+	std::atomic<uint32_t> droppedBytes{0}; // written by the producer only
+
+public:
+	static constexpr size_t capacity(){
+		return Size;
+	}
+
+	/*
+	 * Producer side. Append [first, last) as far as it fits and return the number of stored bytes.
+	 */
+	template<typename _ForwardIterator>
+	size_t push(_ForwardIterator __first, _ForwardIterator __last){
+		const uint32_t write = copyCursor.load(std::memory_order_relaxed);
+		const uint32_t read = readCursor.load(std::memory_order_acquire);
+		const size_t len = std::min<size_t>(std::distance(__first, __last), Size - (write - read));
+		const _ForwardIterator __end = std::next(__first, len);
+
+		//avoid over-flow
+		const size_t firstPart = std::min<size_t>(len, Size - (write & MASK));
+		const _ForwardIterator __split = std::next(__first, firstPart);
+		std::copy(__first, __split, buffer.begin() + (write & MASK));
+		std::copy(__split, __end, buffer.begin());
+		copyCursor.store(write + len, std::memory_order_release);
+		const size_t dropped = std::distance(__first, __last) - len;
+		if(dropped > 0){
+			droppedBytes.store(droppedBytes.load(std::memory_order_relaxed) + dropped, std::memory_order_relaxed);
+		}
+		return len;
+	}
+
+	/*
+	 * Producer side, to fill the ring in place (e.g. with read()) instead of copying through push().
+	 * Returns the contiguous free space at the write position and its length in len; the free space
+	 * which wraps to the start of the buffer is returned by the next call. commit() publishes len written bytes.
+	 */
+	uint8_t* writable(size_t &len){
+		const uint32_t write = copyCursor.load(std::memory_order_relaxed);
+		const uint32_t read = readCursor.load(std::memory_order_acquire);
+		len = std::min<size_t>(Size - (write - read), Size - (write & MASK));
+		return buffer.data() + (write & MASK);
+	}
+
+	void commit(size_t len){
+		copyCursor.store(copyCursor.load(std::memory_order_relaxed) + len, std::memory_order_release);
+	}
+
+	/*
+	 * Free-running totals for statistics, readable from either side:
+	 * bytes which arrived at the ring, and bytes of them which were lost because the ring was full.
+	 */
+	uint32_t received() const {
+		return copyCursor.load(std::memory_order_relaxed) + droppedBytes.load(std::memory_order_relaxed);
+	}
+	uint32_t dropped() const {
+		return droppedBytes.load(std::memory_order_relaxed);
+	}
+
+	/*
+	 * Consumer side. Offsets are relative to the oldest unread byte.
+	 */
+	size_t readable() const {
+		const uint32_t write = copyCursor.load(std::memory_order_acquire);
+		const uint32_t read = readCursor.load(std::memory_order_relaxed);
+		return write - read;
+	}
+
+	uint8_t peek(size_t offset) const {
+		return buffer[(readCursor.load(std::memory_order_relaxed) + offset) & MASK];
+	}
+
+	FrameView view(size_t offset, size_t len) const {
+		const uint32_t start = (readCursor.load(std::memory_order_relaxed) + offset) & MASK;
+		const size_t firstPart = std::min<size_t>(len, Size - start);
+		return FrameView(buffer.data() + start, firstPart, buffer.data(), len - firstPart);
+	}
+
+	/*
+	 * Return the offset of the first value in [offset, offset + len), or offset + len if there is none.
+	 * The range is searched as (at most) two contiguous segments.
+	 */
+	size_t find(uint8_t value, size_t offset, size_t len) const {
+#if COMMAND_RESYNC_USE_MEMCHR
+		const FrameView area = view(offset, len);
+		const void* found = std::memchr(area.headData(), value, area.headSize());
+		if(found != nullptr){
+			return offset + (static_cast<const uint8_t*>(found) - area.headData());
+		}
+		found = area.tailSize() > 0 ? std::memchr(area.tailData(), value, area.tailSize()) : nullptr;
+		if(found != nullptr){
+			return offset + area.headSize() + (static_cast<const uint8_t*>(found) - area.tailData());
+		}
+		return offset + len;
+#else
+		for(; len > 0 && peek(offset) != value; len--){
+			offset++;
+		}
+		return offset;
+#endif
+	}
+
+	void consume(size_t len){
+		const uint32_t read = readCursor.load(std::memory_order_relaxed);
+		readCursor.store(read + len, std::memory_order_release);
+	}
+
+	/*
+	 * Consumer side. Drop every unread byte.
+	 */
+	void clear(){
+		readCursor.store(copyCursor.load(std::memory_order_acquire), std::memory_order_release);
+	}
+};
+
+} /* namespace command */
+
+#endif /* COMMAND_INC_RECEIVERING_HPP_ */
@@ -0,0 +1,317 @@
+/*
+ * RequestTracker.hpp
+ *
+ *  Created on: Mar 17, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#ifndef COMMAND_INC_REQUESTTRACKER_HPP_
+#define COMMAND_INC_REQUESTTRACKER_HPP_
+
+#include "CommandManager.h"
+#include "Callback.hpp"
+#include <array>
+#include <cstdint>
+
+namespace command {
+
+/*
+ * Histogram of latencies in microseconds with power of two buckets: bucket 0 counts 0 us,
+ * bucket k counts [2^(k-1), 2^k) us.
+ */
+struct LatencyHistogram {
+	static constexpr size_t BUCKETS = 33;
+
+	std::array<uint32_t, BUCKETS> buckets = {};
+	uint32_t count = 0;
+	uint32_t min = UINT32_MAX;
+	uint32_t max = 0;
+	uint64_t total = 0;
+
+	static constexpr size_t bucketOf(uint32_t us){
+		size_t bucket = 0;
+		while(us != 0){
+			us >>= 1;
+			bucket++;
+		}
+		return bucket;
+	}
+
+	void add(uint32_t us){
+		buckets[bucketOf(us)]++;
+		count++;
+		min = us < min ? us : min;
+		max = us > max ? us : max;
+		total += us;
+	}
+
+	uint32_t mean() const {
+		return count > 0 ? static_cast<uint32_t>(total / count) : 0;
+	}
+
+	/*
+	 * Upper bound of the bucket which holds the fraction q (0 to 1) of the samples, clamped to max.
+	 * Returns 0 without samples.
+	 */
+	uint32_t quantile(double q) const {
+		if(count == 0){
+			return 0;
+		}
+		const uint32_t rank = q <= 0 ? 1 : q >= 1 ? count : static_cast<uint32_t>(q * count + 0.999999);
+		uint32_t seen = 0;
+		for(size_t bucket = 0; bucket < BUCKETS; bucket++){
+			seen += buckets[bucket];
+			if(seen >= rank){
+				const uint32_t upper = bucket == 0 ? 0 : bucket >= 32 ? UINT32_MAX : (uint32_t(1) << bucket) - 1;
+				return upper < max ? upper : max;
+			}
+		}
+		return max;
+	}
+};
+
+/*
+ * Counters of RequestTracker since the last resetStatistics().
+ */
+struct RequestStatistics {
+	uint32_t requested = 0;   // accepted request() calls
+	uint32_t transmitted = 0; // Request frames sent, including retries
+	uint32_t answered = 0;
+	uint32_t timedOut = 0;
+	uint32_t refused = 0;     // request() calls while the same ID was outstanding
+	std::array<LatencyHistogram, static_cast<uint8_t>(COMMAND_ID::Last)> latency = {}; // round trip per requested ID
+
+	LatencyHistogram latencyOf(COMMAND_ID id) const {
+		return latency[static_cast<uint8_t>(id)];
+	}
+};
+
+/*
+ * Sends Request commands and matches them with the answers, so the requesting side knows whether and when
+ * a command it asked for arrived instead of requesting it again blindly.
+ *
+ *   Request request;
+ *   manager[COMMAND_ID::Request] = &request;
+ *   RequestTracker<> tracker(manager, request, &microseconds);
+ *   tracker.setAnsweredHandler([](COMMAND_ID id, uint32_t us){ ... });
+ *   tracker.setTimeoutHandler([](COMMAND_ID id){ ... });
+ *   tracker.attach(manager);
+ *   tracker.request(COMMAND_ID::GPS, 200000, 2); // answer within 200 ms, send at most twice more
+ *   for(;;){ ...receive...; manager.processReceiveAll(); tracker.poll(); }
+ *
+ * At most one request per ID is outstanding: request() refuses to send another one until the first was
+ * answered or timed out. The first validated command of the requested ID after the request answers it,
+ * so telemetry of the same ID sent periodically answers it as well.
+ *
+ * Deadlines are kept in a hashed timer wheel of WheelSlots slots of tickUs each: request() and answers are O(1),
+ * and poll() visits one slot per elapsed tick, whatever the number of outstanding requests.
+ * The clock returns microseconds and may wrap around. Callbacks run from poll() and the frame observer,
+ * and may call request() again. Not thread safe; call it from the thread which parses.
+ */
+template<class Manager = CommandManager, size_t WheelSlots = 64>
+class RequestTracker {
+	static constexpr uint8_t ID_COUNT = static_cast<uint8_t>(COMMAND_ID::Last);
+	static constexpr uint8_t NONE = 0xff;
+	static_assert(ID_COUNT < NONE, "COMMAND_ID does not fit the wheel links");
+
+	struct Entry {
+		bool outstanding = false;
+		uint8_t retries = 0;  // sends left after the current one
+		uint8_t prev = NONE;  // neighbors in the list of the wheel slot
+		uint8_t next = NONE;
+		uint32_t timeoutUs = 0;
+		uint32_t sentAt = 0;  // clock of the last send
+		uint32_t deadline = 0; // tick
+	};
+
+	Manager &manager;
+	Request &requestHandler;
+	Callback<uint32_t()> clock;
+	const uint32_t tickUs;
+	std::array<Entry, ID_COUNT> entries = {};
+	std::array<uint8_t, WheelSlots> slots;
+	uint32_t tick = 0;     // last tick poll() visited
+	uint32_t tickTime;     // clock at the start of tick
+	RequestStatistics stats;
+	Callback<void(COMMAND_ID, uint32_t)> answered;
+	Callback<void(COMMAND_ID)> timedOut;
+	Callback<void(COMMAND_ID, const FrameView&)> next;
+
+public:
+	/*
+	 * requestHandler is the Request handler of manager which is sent. clock returns microseconds.
+	 */
+	RequestTracker(Manager &manager, Request &requestHandler, Callback<uint32_t()> clock, uint32_t tickUs = 1000)
+		:manager(manager),requestHandler(requestHandler),clock(clock),tickUs(tickUs > 0 ? tickUs : 1),tickTime(clock()){
+		slots.fill(NONE);
+	}
+
+	/*
+	 * answered(id, roundTripUs) is called when the command of an outstanding request arrived.
+	 */
+	void setAnsweredHandler(Callback<void(COMMAND_ID, uint32_t)> answered){
+		this->answered = answered;
+	}
+
+	/*
+	 * timedOut(id) is called from poll() when the last send of a request was not answered in time.
+	 */
+	void setTimeoutHandler(Callback<void(COMMAND_ID)> timedOut){
+		this->timedOut = timedOut;
+	}
+
+	/*
+	 * Match the validated commands of manager from now on. This replaces the frame observer of manager;
+	 * every command is passed on to next, e.g. to record it as well.
+	 */
+	void attach(Manager &manager, Callback<void(COMMAND_ID, const FrameView&)> next = {}){
+		this->next = next;
+		manager.setFrameObserver(Callback<void(COMMAND_ID, const FrameView&)>::bind<&RequestTracker::onFrame>(*this));
+	}
+
+	/*
+	 * Send a Request for id and expect the answer within timeoutUs, sending it again up to retries times
+	 * after each timeout. Returns false when id is not valid or already outstanding.
+	 */
+	bool request(COMMAND_ID id, uint32_t timeoutUs, uint8_t retries = 0){
+		const uint8_t index = static_cast<uint8_t>(id);
+		if(index >= ID_COUNT){
+			return false;
+		}
+		Entry &entry = entries[index];
+		if(entry.outstanding){
+			stats.refused++;
+			return false;
+		}
+		entry.outstanding = true;
+		entry.retries = retries;
+		entry.timeoutUs = timeoutUs;
+		stats.requested++;
+		send(index);
+		return true;
+	}
+
+	/*
+	 * Forget the outstanding request of id without calling any handler.
+	 */
+	void cancel(COMMAND_ID id){
+		const uint8_t index = static_cast<uint8_t>(id);
+		if(index < ID_COUNT && entries[index].outstanding){
+			unlink(index);
+			entries[index].outstanding = false;
+		}
+	}
+
+	bool isOutstanding(COMMAND_ID id) const {
+		return static_cast<uint8_t>(id) < ID_COUNT && entries[static_cast<uint8_t>(id)].outstanding;
+	}
+
+	uint8_t outstanding() const {
+		uint8_t res = 0;
+		for(const Entry &entry : entries){
+			res += entry.outstanding ? 1 : 0;
+		}
+		return res;
+	}
+
+	/*
+	 * Advance the wheel to the clock: send the retries due and report the requests which timed out.
+	 * Returns the number of timeouts.
+	 */
+	uint8_t poll(){
+		uint8_t expired = 0;
+		while(clock() - tickTime >= tickUs){
+			tickTime += tickUs;
+			tick++;
+			// start over after every expiry: the handlers may request or cancel other IDs
+			uint8_t index = slots[tick % WheelSlots];
+			while(index != NONE){
+				if(entries[index].deadline == tick){
+					expired += expire(index);
+					index = slots[tick % WheelSlots];
+				}else{
+					index = entries[index].next;
+				}
+			}
+		}
+		return expired;
+	}
+
+	RequestStatistics statistics() const {
+		return stats;
+	}
+
+	void resetStatistics(){
+		stats = RequestStatistics();
+	}
+
+	void onFrame(COMMAND_ID id, const FrameView &body){
+		const uint8_t index = static_cast<uint8_t>(id);
+		if(index < ID_COUNT && entries[index].outstanding){
+			const uint32_t latency = clock() - entries[index].sentAt;
+			unlink(index);
+			entries[index].outstanding = false;
+			stats.answered++;
+			stats.latency[index].add(latency);
+			answered(id, latency);
+		}
+		next(id, body);
+	}
+
+private:
+	void send(uint8_t index){
+		Entry &entry = entries[index];
+		requestHandler.setRequestCommandId(static_cast<COMMAND_ID>(index));
+		manager.transmit(COMMAND_ID::Request);
+		stats.transmitted++;
+		entry.sentAt = clock();
+		// the current tick already started, so wait one tick more to never fire early
+		const uint32_t ticks = (entry.timeoutUs + (entry.sentAt - tickTime) + tickUs - 1) / tickUs;
+		entry.deadline = tick + (ticks > 0 ? ticks : 1);
+		link(index);
+	}
+
+	// Returns 1 when the request timed out for good, 0 when it was sent again.
+	uint8_t expire(uint8_t index){
+		Entry &entry = entries[index];
+		unlink(index);
+		if(entry.retries > 0){
+			entry.retries--;
+			send(index);
+			return 0;
+		}
+		entry.outstanding = false;
+		stats.timedOut++;
+		timedOut(static_cast<COMMAND_ID>(index));
+		return 1;
+	}
+
+	void link(uint8_t index){
+		Entry &entry = entries[index];
+		uint8_t &head = slots[entry.deadline % WheelSlots];
+		entry.prev = NONE;
+		entry.next = head;
+		if(head != NONE){
+			entries[head].prev = index;
+		}
+		head = index;
+	}
+
+	void unlink(uint8_t index){
+		Entry &entry = entries[index];
+		if(entry.prev != NONE){
+			entries[entry.prev].next = entry.next;
+		}else{
+			slots[entry.deadline % WheelSlots] = entry.next;
+		}
+		if(entry.next != NONE){
+			entries[entry.next].prev = entry.prev;
+		}
+		entry.prev = NONE;
+		entry.next = NONE;
+	}
+};
+
+} /* namespace command */
+
+#endif /* COMMAND_INC_REQUESTTRACKER_HPP_ */
@@ -0,0 +1,343 @@
+/*
+ * SerialTransport.hpp
+ *
+ *  Created on: Mar 15, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#ifndef COMMAND_INC_SERIALTRANSPORT_HPP_
+#define COMMAND_INC_SERIALTRANSPORT_HPP_
+
+#include "CommandManager.h"
+
+#if defined(__linux__)
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace command {
+
+/*
+ * A tty device in raw mode (8N1, no flow control, no line discipline) and non-blocking, or one end of a pty pair
+ * to run both ends of a link on one host without hardware. Closes the descriptor on destruction.
+ */
+class SerialPort {
+	int descriptor = -1;
+
+public:
+	SerialPort() = default;
+	SerialPort(const SerialPort&) = delete;
+	SerialPort& operator=(const SerialPort&) = delete;
+	~SerialPort(){
+		close();
+	}
+
+	/*
+	 * Open the tty at path with baud bits/s. Returns false when it can not be opened or baud is not a standard rate.
+	 */
+	bool open(const char* path, uint32_t baud);
+
+	/*
+	 * Open a new pty pair: this port becomes the master and other the slave. What is written to one is read from the other.
+	 */
+	bool openPty(SerialPort &other);
+
+	void close();
+
+	int fd() const {
+		return descriptor;
+	}
+	bool isOpen() const {
+		return descriptor >= 0;
+	}
+};
+
+/*
+ * Counters of SerialTransport since the last resetStatistics().
+ * The latency is measured from the return of the read() which completed frames to the return of their dispatch,
+ * one sample per such read.
+ */
+struct TransportStatistics {
+	uint64_t bytesRead = 0;
+	uint64_t bytesWritten = 0;
+	uint64_t reads = 0;
+	uint64_t writes = 0;
+	uint64_t framesReceived = 0; // dispatched commands
+	uint64_t framesSent = 0;     // frames queued by send()
+	uint64_t framesRefused = 0;  // frames send() had no room for even after writing what the device accepted
+	uint64_t latencySamples = 0;
+	uint64_t latencyTotalNs = 0;
+	uint64_t latencyMaxNs = 0;
+	int64_t elapsedNs = 0;
+
+	double readRate() const {
+		return elapsedNs > 0 ? bytesRead * 1e9 / elapsedNs : 0.0;
+	}
+	double writeRate() const {
+		return elapsedNs > 0 ? bytesWritten * 1e9 / elapsedNs : 0.0;
+	}
+	double meanLatencyNs() const {
+		return latencySamples > 0 ? static_cast<double>(latencyTotalNs) / latencySamples : 0.0;
+	}
+};
+
+/*
+ * Host transport of one manager over a tty, pty or any other stream descriptor, driven by poll() from one thread.
+ *
+ *   SerialPort port;
+ *   port.open("/dev/ttyUSB0", 115200);
+ *   SerialTransport<> link(manager, port.fd());
+ *   for(;;){ link.poll(10); }
+ *
+ * Reads go straight into the free space of the receive ring, up to READ_BUDGET bytes per wakeup, and are
+ * parsed as they arrive. send() serializes a frame into the transmit buffer with constructTransmitFrameInto()
+ * and does not write it: everything queued, including the responses of the handlers to the frames just received,
+ * goes out in as few write() calls as possible at the end of poll() or on flush(). When the device does not
+ * accept all of it, the rest is written as soon as it is writable again.
+ */
+template<class Manager = CommandManager, size_t TxCapacity = 4096>
+class SerialTransport {
+	static_assert(TxCapacity >= Manager::MAX_FRAME_LEN, "TxCapacity must hold the longest frame");
+	using Clock = std::chrono::steady_clock;
+
+	Manager &manager;
+	const int fd;
+	int epoll = -1;
+	bool open = false;
+	bool writeArmed = false;
+	// frames queued in [txHead, txTail)
+	std::array<uint8_t, TxCapacity> tx;
+	size_t txHead = 0;
+	size_t txTail = 0;
+	TransportStatistics stats;
+	Clock::time_point since = Clock::now();
+
+public:
+	static constexpr size_t READ_BUDGET = 64 * 1024;
+
+	/*
+	 * fd must be non-blocking, e.g. a SerialPort. It is not closed by the transport.
+	 */
+	SerialTransport(Manager &manager, int fd):manager(manager),fd(fd){
+		epoll = epoll_create1(EPOLL_CLOEXEC);
+		epoll_event event = {};
+		event.events = EPOLLIN;
+		open = epoll >= 0 && fd >= 0 && epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event) == 0;
+	}
+	SerialTransport(const SerialTransport&) = delete;
+	SerialTransport& operator=(const SerialTransport&) = delete;
+	~SerialTransport(){
+		if(epoll >= 0){
+			::close(epoll);
+		}
+	}
+
+	/*
+	 * False once the device reached end of file or failed, e.g. the other end of a pty was closed.
+	 */
+	bool isOpen() const {
+		return open;
+	}
+
+	/*
+	 * Queue the frame of id. When the transmit buffer has no room for it, e.g. for the responses to a burst of
+	 * Requests parsed in one poll(), what is queued is written first. Returns false when id has no handler or
+	 * the device does not accept enough to make room; the latter is counted in framesRefused.
+	 */
+	bool send(COMMAND_ID id){
+		if(static_cast<uint8_t>(id) >= static_cast<uint8_t>(COMMAND_ID::Last)){
+			return false;
+		}
+		const size_t frameLen = Manager::getFrameLen(id);
+		if(TxCapacity - txTail < frameLen){
+			compact();
+			if(TxCapacity - txTail < frameLen){
+				flush();
+				compact();
+			}
+			if(TxCapacity - txTail < frameLen){
+				stats.framesRefused++;
+				return false;
+			}
+		}
+		const size_t len = manager.constructTransmitFrameInto(id, tx.data() + txTail, TxCapacity - txTail);
+		if(len == 0){
+			return false;
+		}
+		txTail += len;
+		stats.framesSent++;
+		return true;
+	}
+
+	/*
+	 * Bytes queued and not written yet.
+	 */
+	size_t pending() const {
+		return txTail - txHead;
+	}
+
+	/*
+	 * Write as much of the queue as the device accepts. Returns true when nothing is left.
+	 */
+	bool flush(){
+		while(open && txHead < txTail){
+			const ssize_t len = write(fd, tx.data() + txHead, txTail - txHead);
+			if(len > 0){
+				txHead += static_cast<size_t>(len);
+				stats.bytesWritten += static_cast<size_t>(len);
+				stats.writes++;
+			}else if(len < 0 && errno == EINTR){
+				continue;
+			}else{
+				if(len == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)){
+					close();
+				}
+				break;
+			}
+		}
+		if(txHead == txTail){
+			txHead = 0;
+			txTail = 0;
+		}
+		armWrite(open && txHead < txTail);
+		return txHead == txTail;
+	}
+
+	/*
+	 * Write what was queued, wait up to timeoutMs (-1 forever, 0 not at all) for the device, parse and dispatch
+	 * what arrived and write the responses. Returns the number of dispatched commands.
+	 */
+	size_t poll(int timeoutMs){
+		if(!open){
+			return 0;
+		}
+		flush();
+		epoll_event event;
+		size_t frames = 0;
+		if(epoll_wait(epoll, &event, 1, timeoutMs) == 1){
+			if(event.events & EPOLLOUT){
+				flush();
+			}
+			if(event.events & (EPOLLIN | EPOLLHUP | EPOLLERR)){
+				frames = receive();
+			}
+		}
+		flush();
+		return frames;
+	}
+
+	TransportStatistics statistics() const {
+		TransportStatistics res = stats;
+		res.elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - since).count();
+		return res;
+	}
+
+	void resetStatistics(){
+		stats = TransportStatistics();
+		since = Clock::now();
+	}
+
+private:
+	void compact(){
+		if(txHead > 0){
+			std::memmove(tx.data(), tx.data() + txHead, txTail - txHead);
+			txTail -= txHead;
+			txHead = 0;
+		}
+	}
+
+	size_t receive(){
+		typename Manager::Ring &ring = manager.receiveRing();
+		size_t frames = 0;
+		size_t budget = READ_BUDGET;
+		while(open && budget > 0){
+			// the parser only leaves an unfinished frame behind, so there is room (rxCapacity >= 2 frames);
+			// a read of 0 bytes would look like end of file
+			size_t space = 0;
+			uint8_t* dest = ring.writable(space);
+			if(space == 0){
+				break;
+			}
+			const ssize_t len = read(fd, dest, std::min(space, budget));
+			if(len > 0){
+				const Clock::time_point readDone = Clock::now();
+				ring.commit(static_cast<size_t>(len));
+				budget -= static_cast<size_t>(len);
+				stats.bytesRead += static_cast<size_t>(len);
+				stats.reads++;
+				const uint16_t dispatched = manager.processReceiveAll().frames;
+				if(dispatched > 0){
+					const uint64_t latency = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - readDone).count();
+					frames += dispatched;
+					stats.framesReceived += dispatched;
+					stats.latencySamples++;
+					stats.latencyTotalNs += latency;
+					stats.latencyMaxNs = std::max(stats.latencyMaxNs, latency);
+				}
+			}else if(len < 0 && errno == EINTR){
+				continue;
+			}else{
+				// a pty master reads EIO once the slave is closed
+				if(len == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)){
+					close();
+				}
+				break;
+			}
+		}
+		return frames;
+	}
+
+	void armWrite(bool armed){
+		if(armed == writeArmed || epoll < 0){
+			return;
+		}
+		epoll_event event = {};
+		event.events = armed ? EPOLLIN | EPOLLOUT : EPOLLIN;
+		epoll_ctl(epoll, EPOLL_CTL_MOD, fd, &event);
+		writeArmed = armed;
+	}
+
+	void close(){
+		if(open){
+			epoll_ctl(epoll, EPOLL_CTL_DEL, fd, nullptr);
+			open = false;
+			writeArmed = false;
+		}
+	}
+};
+
+/*
+ * Manager whose transmit() queues the frame on a SerialTransport, so the responses of handlers go out on the link.
+ * Responses which do not fit are written out during the dispatch; those the device does not take either are
+ * dropped and counted in TransportStatistics::framesRefused.
+ *
+ *   TransportCommandManager<> manager;
+ *   SerialTransport<TransportCommandManager<>> link(manager, port.fd());
+ *   manager.setTransport(&link);
+ */
+template<class Config = DefaultManagerConfig, size_t TxCapacity = 4096>
+class TransportCommandManager : public BasicCommandManager<Config> {
+	SerialTransport<TransportCommandManager, TxCapacity>* transport = nullptr;
+
+public:
+	void setTransport(SerialTransport<TransportCommandManager, TxCapacity>* transport){
+		this->transport = transport;
+	}
+
+	void transmit(const COMMAND_ID id) override {
+		if(transport != nullptr && id != COMMAND_ID::Last){
+			transport->send(id);
+		}
+	}
+};
+
+} /* namespace command */
+
+#endif /* __linux__ */
+
+#endif /* COMMAND_INC_SERIALTRANSPORT_HPP_ */
@@ -0,0 +1,407 @@
+/*
+ * TelemetryColumns.hpp
+ *
+ *  Created on: Mar 13, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#ifndef COMMAND_INC_TELEMETRYCOLUMNS_HPP_
+#define COMMAND_INC_TELEMETRYCOLUMNS_HPP_
+
+#include "CommandHandlerBase.h"
+#include "CommandWireSchema.hpp"
+#include "FlightLog.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace command {
+namespace columnar {
+
+/*
+ * File format of TelemetryColumns. All values are little endian (the host order of the ground station).
+ *
+ *   FileHeader
+ *   TableEntry[tableCount]     one per exported COMMAND_ID
+ *   ColumnEntry[columnCount]   columns of a table are firstColumn to firstColumn + columnCount - 1
+ *   column data                rows values of the column Type, at a multiple of COLUMN_ALIGN
+ *
+ * The first column of every table is "time" (int64 ns, CLOCK_REALTIME of the flight log), followed by one
+ * column per field of the wire schema in tie() order. Array fields have one column per element (gyro.x, gyro.y, ...).
+ * Columns are plain arrays, so a mapped file needs no parsing: numpy.memmap(path, dtype, offset=offset, shape=rows).
+ */
+static constexpr uint64_t FILE_MAGIC = 0x314c4f43444d43ULL; // "CMDCOL1"
+static constexpr uint32_t VERSION = 1;
+static constexpr size_t COLUMN_ALIGN = 64;
+static constexpr size_t NAME_SIZE = 32;
+
+enum class Type : uint8_t {
+	Bool,    // uint8 0 or 1
+	Int8,
+	UInt8,
+	Int16,
+	UInt16,
+	Int32,
+	UInt32,
+	Int64,
+	Float32,
+	Float64
+};
+
+struct FileHeader {
+	uint64_t magic;
+	uint32_t version;
+	uint32_t tableCount;
+	uint32_t columnCount;
+	uint32_t reserved;
+	uint64_t skipped; // records of the log without a table or with a wrong body length
+};
+
+struct TableEntry {
+	char name[NAME_SIZE];
+	uint8_t id;       // COMMAND_ID
+	uint8_t reserved[3];
+	uint32_t firstColumn;
+	uint32_t columnCount;
+	uint32_t reserved2;
+	uint64_t rows;
+};
+
+struct ColumnEntry {
+	char name[NAME_SIZE];
+	Type type;
+	uint8_t elementSize;
+	uint16_t reserved;
+	uint32_t table;
+	uint64_t offset;  // from the start of the file
+	uint64_t bytes;
+};
+
+static_assert(sizeof(FileHeader) == 32 && sizeof(TableEntry) == 56 && sizeof(ColumnEntry) == 56,
+              "columnar headers must not have padding");
+
+template<typename T>
+constexpr Type typeOf(){
+	if constexpr(std::is_enum<T>::value){
+		return typeOf<std::underlying_type_t<T>>();
+	}else if constexpr(std::is_same<T, bool>::value){
+		return Type::Bool;
+	}else if constexpr(std::is_same<T, int8_t>::value){
+		return Type::Int8;
+	}else if constexpr(std::is_same<T, uint8_t>::value){
+		return Type::UInt8;
+	}else if constexpr(std::is_same<T, int16_t>::value){
+		return Type::Int16;
+	}else if constexpr(std::is_same<T, uint16_t>::value){
+		return Type::UInt16;
+	}else if constexpr(std::is_same<T, int32_t>::value){
+		return Type::Int32;
+	}else if constexpr(std::is_same<T, uint32_t>::value){
+		return Type::UInt32;
+	}else if constexpr(std::is_same<T, int64_t>::value){
+		return Type::Int64;
+	}else if constexpr(std::is_same<T, float>::value){
+		return Type::Float32;
+	}else{
+		static_assert(std::is_same<T, double>::value, "no column type for this field");
+		return Type::Float64;
+	}
+}
+
+namespace detail {
+
+// Type of the column of a field: enums as their underlying integer, bool as uint8.
+template<typename T, typename = void>
+struct Stored {
+	using type = T;
+};
+template<typename T>
+struct Stored<T, std::enable_if_t<std::is_enum<T>::value>> {
+	using type = std::underlying_type_t<T>;
+};
+template<>
+struct Stored<bool> {
+	using type = uint8_t;
+};
+
+template<typename T>
+void describeColumn(ColumnEntry &column, const char* name, const char* suffix){
+	std::snprintf(column.name, NAME_SIZE, "%s%s", name, suffix);
+	column.type = typeOf<T>();
+	column.elementSize = sizeof(typename Stored<T>::type);
+}
+
+/*
+ * Columns of one element of a tie() tuple: a field bound by reference, an array, or a tuple of bit fields.
+ * Leaf<K> is the field type of column K of the element and get<K>() reads it from the decoded element.
+ */
+template<typename E>
+struct Leaves;
+
+template<typename T>
+struct Leaves<T&> {
+	static constexpr size_t columns = 1;
+	static constexpr size_t names = 1;
+
+	template<size_t K>
+	using Leaf = T;
+
+	template<size_t K>
+	static const T& get(const T &value){
+		return value;
+	}
+	static void describe(const char* const* name, ColumnEntry* out){
+		describeColumn<T>(out[0], name[0], "");
+	}
+};
+
+// A parameter of the codec, like the full scale of ScaledInt16; not a field.
+template<typename T>
+struct Leaves<const T&> {
+	static constexpr size_t columns = 0;
+	static constexpr size_t names = 0;
+
+	static void describe(const char* const*, ColumnEntry*){}
+};
+
+template<typename T, size_t N>
+struct Leaves<std::array<T, N>&> {
+	static_assert(N <= 4, "array columns are named x, y, z, w");
+	static constexpr size_t columns = N;
+	static constexpr size_t names = 1;
+
+	template<size_t K>
+	using Leaf = T;
+
+	template<size_t K>
+	static const T& get(const std::array<T, N> &value){
+		return value[K];
+	}
+	static void describe(const char* const* name, ColumnEntry* out){
+		constexpr const char* suffix[] = {".x", ".y", ".z", ".w"};
+		for(size_t i = 0; i < N; i++){
+			describeColumn<T>(out[i], name[0], suffix[i]);
+		}
+	}
+};
+
+template<typename... E>
+struct Leaves<std::tuple<E...>> {
+	static constexpr size_t columns = (Leaves<E>::columns + ... + 0);
+	static constexpr size_t names = (Leaves<E>::names + ... + 0);
+
+	template<size_t I>
+	static constexpr size_t columnOffset(){
+		constexpr size_t counts[] = {Leaves<E>::columns..., 0};
+		size_t res = 0;
+		for(size_t i = 0; i < I; i++){
+			res += counts[i];
+		}
+		return res;
+	}
+	template<size_t I>
+	static constexpr size_t nameOffset(){
+		constexpr size_t counts[] = {Leaves<E>::names..., 0};
+		size_t res = 0;
+		for(size_t i = 0; i < I; i++){
+			res += counts[i];
+		}
+		return res;
+	}
+	// element holding column K
+	template<size_t K>
+	static constexpr size_t elementOf(){
+		constexpr size_t counts[] = {Leaves<E>::columns..., 0};
+		size_t i = 0;
+		for(size_t first = counts[0]; first <= K; first += counts[i]){
+			i++;
+		}
+		return i;
+	}
+
+	template<size_t K>
+	using Element = Leaves<std::tuple_element_t<elementOf<K>(), std::tuple<E...>>>;
+	template<size_t K>
+	using Leaf = typename Element<K>::template Leaf<K - columnOffset<elementOf<K>()>()>;
+
+	template<size_t K>
+	static const Leaf<K>& get(const std::tuple<E...> &value){
+		return Element<K>::template get<K - columnOffset<elementOf<K>()>()>(std::get<elementOf<K>()>(value));
+	}
+	static void describe(const char* const* name, ColumnEntry* out){
+		describeEach(name, out, std::index_sequence_for<E...>());
+	}
+
+private:
+	template<size_t... I>
+	static void describeEach(const char* const* name, ColumnEntry* out, std::index_sequence<I...>){
+		(Leaves<E>::describe(name + nameOffset<I>(), out + columnOffset<I>()), ...);
+	}
+};
+
+} /* namespace detail */
+
+/*
+ * Column decoder of Value in the wire format of Codec (a wire::Schema, or wire::CompactImu with its full scale as Args).
+ * decode() turns rows bodies laid out back to back into one array per field. It fills one column at a time:
+ * every loop decodes a constant offset at a constant stride into one contiguous array, which the compiler
+ * vectorizes, instead of decoding and scattering one record at a time.
+ */
+template<typename Codec, typename Value, typename... Args>
+class TableColumns {
+	using Format = typename Codec::Format;
+	using Tied = decltype(Codec::tie(std::declval<Value&>(), std::declval<const Args&>()...));
+	using Fields = detail::Leaves<Tied>;
+
+	static_assert(Fields::names == Codec::names.size(), "the schema must name every field");
+
+public:
+	static constexpr size_t columns = Fields::columns;
+	static constexpr size_t bodySize = Format::size;
+
+	static void describe(ColumnEntry* out){
+		Fields::describe(Codec::names.data(), out);
+	}
+
+	/*
+	 * columns[i] points to rows values of column i.
+	 */
+	static void decode(const uint8_t* bodies, size_t rows, void* const* columns, const Args&... args){
+		decodeColumns(bodies, rows, columns, args..., std::make_index_sequence<Fields::columns>());
+	}
+
+private:
+	template<size_t... K>
+	static void decodeColumns(const uint8_t* bodies, size_t rows, void* const* columns, const Args&... args, std::index_sequence<K...>){
+		(decodeColumn<K>(bodies, rows, columns[K], args...), ...);
+	}
+
+	template<size_t K>
+	static void decodeColumn(const uint8_t* __restrict bodies, size_t rows, void* column, const Args&... args){
+		constexpr size_t field = Fields::template elementOf<K>();
+		using Field = typename Format::template Field<field>;
+		using Leaves = detail::Leaves<std::tuple_element_t<field, Tied>>;
+		constexpr size_t leaf = K - Fields::template columnOffset<field>();
+		using Stored = typename detail::Stored<typename Leaves::template Leaf<leaf>>::type;
+		constexpr size_t offset = Format::template offset<field>();
+
+		Stored* __restrict out = static_cast<Stored*>(column);
+		for(size_t row = 0; row < rows; row++){
+			// decoded into a temporary of each row, which the compiler keeps in registers
+			Value value;
+			auto tied = Codec::tie(value, args...);
+			Field::decode(FrameView(bodies + row * bodySize, bodySize), offset, std::get<field>(tied));
+			out[row] = static_cast<Stored>(Leaves::template get<leaf>(std::get<field>(tied)));
+		}
+	}
+};
+
+} /* namespace columnar */
+} /* namespace command */
+
+#if defined(__linux__)
+
+namespace command {
+
+/*
+ * Columnar export of a flight log for post-flight analysis, and a read-only mapping of it.
+ *
+ *   TelemetryColumns::write(log, "flight.columns");
+ *
+ *   TelemetryColumns columns;
+ *   columns.open("flight.columns");
+ *   size_t rows;
+ *   const float* gyroZ = columns.values<float>(COMMAND_ID::IMU, "gyro.z", rows);
+ *
+ * Every command with a CommandDataType schema gets a table, ImuCompact with the columns of IMU.
+ * Opening maps the file without reading it, so the time to load a log does not depend on its length.
+ */
+class TelemetryColumns {
+	int fd = -1;
+	const uint8_t* map = nullptr;
+	size_t mapSize = 0;
+
+public:
+	TelemetryColumns() = default;
+	TelemetryColumns(const TelemetryColumns&) = delete;
+	TelemetryColumns& operator=(const TelemetryColumns&) = delete;
+	~TelemetryColumns(){
+		close();
+	}
+
+	/*
+	 * Decode every record of log into the columnar file path. ImuCompact records are decoded with scale.
+	 * Returns false when the file could not be written.
+	 */
+	static bool write(const FlightLogReader &log, const char* path, const wire::ImuFullScale &scale = wire::ImuFullScale());
+
+	bool open(const char* path);
+	void close();
+
+	bool isOpen() const {
+		return map != nullptr;
+	}
+
+	const columnar::FileHeader& header() const {
+		return *reinterpret_cast<const columnar::FileHeader*>(map);
+	}
+
+	const columnar::TableEntry& table(size_t i) const {
+		return reinterpret_cast<const columnar::TableEntry*>(map + sizeof(columnar::FileHeader))[i];
+	}
+
+	const columnar::ColumnEntry& column(size_t i) const {
+		return reinterpret_cast<const columnar::ColumnEntry*>(&table(header().tableCount))[i];
+	}
+
+	/*
+	 * Table of id, or nullptr when it was not exported.
+	 */
+	const columnar::TableEntry* find(COMMAND_ID id) const {
+		for(size_t i = 0; i < header().tableCount; i++){
+			if(table(i).id == static_cast<uint8_t>(id)){
+				return &table(i);
+			}
+		}
+		return nullptr;
+	}
+
+	/*
+	 * Column name of table, or nullptr when it has none.
+	 */
+	const columnar::ColumnEntry* find(const columnar::TableEntry &table, const char* name) const {
+		for(size_t i = table.firstColumn; i < table.firstColumn + table.columnCount; i++){
+			if(std::strncmp(column(i).name, name, columnar::NAME_SIZE) == 0){
+				return &column(i);
+			}
+		}
+		return nullptr;
+	}
+
+	/*
+	 * Values of column name of id, or nullptr when there is no such column of type T.
+	 */
+	template<typename T>
+	const T* values(COMMAND_ID id, const char* name, size_t &rows) const {
+		const columnar::TableEntry* entry = find(id);
+		const columnar::ColumnEntry* col = entry != nullptr ? find(*entry, name) : nullptr;
+		if(col == nullptr || col->type != columnar::typeOf<T>() || col->elementSize != sizeof(T)){
+			rows = 0;
+			return nullptr;
+		}
+		rows = entry->rows;
+		return reinterpret_cast<const T*>(map + col->offset);
+	}
+};
+
+} /* namespace command */
+
+#endif /* __linux__ */
+
+#endif /* COMMAND_INC_TELEMETRYCOLUMNS_HPP_ */
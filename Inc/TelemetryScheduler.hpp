@@ -0,0 +1,174 @@
+/*
+ * TelemetryScheduler.hpp
+ *
+ *  Created on: Mar 2, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#ifndef COMMAND_INC_TELEMETRYSCHEDULER_HPP_
+#define COMMAND_INC_TELEMETRYSCHEDULER_HPP_
+
+#include "CommandManager.h"
+#include <array>
+#include <cstdint>
+
+namespace command {
+
+/*
+ * Period and phase of one periodic command, in scheduler ticks.
+ */
+struct TelemetryRate {
+	COMMAND_ID id;
+	uint32_t period;
+	uint32_t phase;
+};
+
+/*
+ * Link bitrate in bit/s needed to send rates at tickHz ticks per second.
+ * Frame lengths come from Manager::getFrameLen(), so framing and integrity overhead are included.
+ * bitsPerByte is 10 for an 8N1 UART. Usable in a static_assert, e.g.
+ *   static_assert(requiredBitrate<CommandManager>(rates, 1000) <= 57600, "telemetry does not fit the radio");
+ */
+template<class Manager, size_t N>
+constexpr uint32_t requiredBitrate(const std::array<TelemetryRate, N> &rates, uint32_t tickHz, uint8_t bitsPerByte = 10){
+	uint64_t bits = 0;
+	for(size_t i = 0; i < N; i++){
+		if(rates[i].period == 0){
+			continue;
+		}
+		const uint64_t frameBits = uint64_t(Manager::getFrameLen(rates[i].id)) * bitsPerByte * tickHz;
+		bits += (frameBits + rates[i].period - 1) / rates[i].period;
+	}
+	return static_cast<uint32_t>(bits);
+}
+
+/*
+ * Sends every command at its own period by calling Manager::transmit(id) from tick().
+ * Call tick() at a fixed rate, e.g. from the main loop on a 1 kHz timer flag.
+ */
+template<class Manager = CommandManager>
+class TelemetryScheduler {
+	struct Entry {
+		uint32_t period = 0;    // 0 disables the command
+		uint32_t phase = 0;
+		uint32_t countdown = 0; // ticks until the next transmission
+	};
+
+	Manager &manager;
+	std::array<Entry, (uint8_t)COMMAND_ID::Last> entries = {};
+
+public:
+	explicit TelemetryScheduler(Manager &manager):manager(manager){}
+
+	/*
+	 * Send id every period ticks, first at tick phase (counted from the next tick()).
+	 * Returns false when id is not valid or period is 0.
+	 */
+	bool setRate(COMMAND_ID id, uint32_t period, uint32_t phase){
+		if(static_cast<uint8_t>(id) >= static_cast<uint8_t>(COMMAND_ID::Last) || period == 0){
+			return false;
+		}
+		Entry &entry = entries[static_cast<uint8_t>(id)];
+		entry.period = period;
+		entry.phase = phase % period;
+		entry.countdown = entry.phase;
+		return true;
+	}
+
+	/*
+	 * Send id every period ticks with the phase which collides with the fewest bytes of the commands set so far.
+	 * Two commands meet at some tick exactly when the ticks until their next transmissions are equal modulo
+	 * the gcd of their periods, so setting the fastest commands first spreads them over the ticks.
+	 * Comparing with the countdowns, not the phases the other commands were set with, also holds between ticks.
+	 */
+	bool setRate(COMMAND_ID id, uint32_t period){
+		if(static_cast<uint8_t>(id) >= static_cast<uint8_t>(COMMAND_ID::Last) || period == 0){
+			return false;
+		}
+		entries[static_cast<uint8_t>(id)].period = 0;
+		uint32_t bestPhase = 0;
+		uint32_t bestLoad = UINT32_MAX;
+		for(uint32_t phase = 0; phase < period && bestLoad > 0; phase++){
+			uint32_t load = 0;
+			for(uint8_t other = 0; other < entries.size(); other++){
+				const Entry &entry = entries[other];
+				if(entry.period == 0){
+					continue;
+				}
+				const uint32_t common = gcd(period, entry.period);
+				if(phase % common == entry.countdown % common){
+					load += Manager::getFrameLen(static_cast<COMMAND_ID>(other));
+				}
+			}
+			if(load < bestLoad){
+				bestLoad = load;
+				bestPhase = phase;
+			}
+		}
+		return setRate(id, period, bestPhase);
+	}
+
+	bool setRate(const TelemetryRate &rate){
+		return setRate(rate.id, rate.period, rate.phase);
+	}
+
+	void disable(COMMAND_ID id){
+		if(static_cast<uint8_t>(id) < static_cast<uint8_t>(COMMAND_ID::Last)){
+			entries[static_cast<uint8_t>(id)].period = 0;
+		}
+	}
+
+	TelemetryRate getRate(COMMAND_ID id) const {
+		const Entry &entry = entries[static_cast<uint8_t>(id)];
+		return {id, entry.period, entry.phase};
+	}
+
+	/*
+	 * Advance one tick and transmit the commands due at it. Returns the number of transmitted commands.
+	 */
+	uint8_t tick(){
+		uint8_t sent = 0;
+		for(uint8_t id = 0; id < entries.size(); id++){
+			Entry &entry = entries[id];
+			if(entry.period == 0){
+				continue;
+			}
+			if(entry.countdown == 0){
+				manager.transmit(static_cast<COMMAND_ID>(id));
+				entry.countdown = entry.period;
+				sent++;
+			}
+			entry.countdown--;
+		}
+		return sent;
+	}
+
+	/*
+	 * Link budget check of the current rates for startup. See requiredBitrate().
+	 */
+	uint32_t requiredBitrate(uint32_t tickHz, uint8_t bitsPerByte = 10) const {
+		std::array<TelemetryRate, (uint8_t)COMMAND_ID::Last> rates = {};
+		for(uint8_t id = 0; id < entries.size(); id++){
+			rates[id] = getRate(static_cast<COMMAND_ID>(id));
+		}
+		return command::requiredBitrate<Manager>(rates, tickHz, bitsPerByte);
+	}
+
+	bool fitsLink(uint32_t tickHz, uint32_t linkBitrate, uint8_t bitsPerByte = 10) const {
+		return requiredBitrate(tickHz, bitsPerByte) <= linkBitrate;
+	}
+
+private:
+	static constexpr uint32_t gcd(uint32_t a, uint32_t b){
+		while(b != 0){
+			const uint32_t r = a % b;
+			a = b;
+			b = r;
+		}
+		return a;
+	}
+};
+
+} /* namespace command */
+
+#endif /* COMMAND_INC_TELEMETRYSCHEDULER_HPP_ */
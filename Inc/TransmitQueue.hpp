@@ -0,0 +1,274 @@
+/*
+ * TransmitQueue.hpp
+ *
+ *  Created on: Mar 4, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#ifndef COMMAND_INC_TRANSMITQUEUE_HPP_
+#define COMMAND_INC_TRANSMITQUEUE_HPP_
+
+#include "CommandManager.h"
+#include "Callback.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace command {
+
+enum class TransmitPriority : uint8_t {
+	Control = 0, // responses and commands; never wait behind telemetry
+	Telemetry,
+	Last
+};
+
+/*
+ * Outbound queue of commands with priority classes, sent through two alternating TX buffers.
+ * While one buffer drains over DMA the next frame is serialized into the other one,
+ * and onTransferComplete() starts it straight from the DMA complete interrupt.
+ *
+ * push()/poll()/transmit() run in the main loop and onTransferComplete() in the DMA interrupt.
+ * Frames are serialized when they are staged, so a command queued twice is sent once with its latest data.
+ * A staged telemetry frame is replaced when a control command arrives, so a control command waits
+ * at most for the frame already on the wire.
+ *
+ * Route handler responses and scheduled telemetry through it, e.g.
+ *   void MyManager::transmit(const COMMAND_ID id){ queue.push(id, TransmitPriority::Control); }
+ *   TelemetryScheduler<TransmitQueue<MyManager>> scheduler(queue);
+ */
+template<class Manager = CommandManager>
+class TransmitQueue {
+	enum class BufferState : uint8_t {
+		Empty,
+		Filling,
+		Ready,
+		Sending
+	};
+	static_assert(std::atomic<BufferState>::is_always_lock_free, "TransmitQueue needs lock-free byte atomics");
+
+	static constexpr uint8_t ID_COUNT = static_cast<uint8_t>(COMMAND_ID::Last);
+	static constexpr uint8_t NO_BUFFER = 0xff;
+
+	/*
+	 * FIFO of distinct COMMAND_IDs of one priority class. It holds every ID at most once, so it never overflows.
+	 */
+	class IdQueue {
+		std::array<COMMAND_ID, ID_COUNT> ids = {};
+		uint8_t head = 0;
+		uint8_t count = 0;
+		uint32_t queued = 0;
+
+	public:
+		bool empty() const {
+			return count == 0;
+		}
+		void pushBack(COMMAND_ID id){
+			if(contains(id)){
+				return;
+			}
+			ids[(head + count) % ID_COUNT] = id;
+			count++;
+			queued |= bit(id);
+		}
+		void pushFront(COMMAND_ID id){
+			if(contains(id)){
+				return;
+			}
+			head = (head + ID_COUNT - 1) % ID_COUNT;
+			ids[head] = id;
+			count++;
+			queued |= bit(id);
+		}
+		COMMAND_ID pop(){
+			const COMMAND_ID id = ids[head];
+			head = (head + 1) % ID_COUNT;
+			count--;
+			queued &= ~bit(id);
+			return id;
+		}
+
+	private:
+		bool contains(COMMAND_ID id) const {
+			return queued & bit(id);
+		}
+		static uint32_t bit(COMMAND_ID id){
+			return uint32_t(1) << static_cast<uint8_t>(id);
+		}
+	};
+
+	Manager &manager;
+	Callback<bool(const uint8_t*, size_t)> startTransfer;
+
+	// main loop only
+	std::array<IdQueue, static_cast<uint8_t>(TransmitPriority::Last)> queues;
+	uint8_t staged = NO_BUFFER;
+	TransmitPriority stagedPriority = TransmitPriority::Last;
+	COMMAND_ID stagedId = COMMAND_ID::Last;
+
+	// shared with the DMA interrupt
+	std::array<std::array<uint8_t, Manager::MAX_FRAME_LEN>, 2> buffers = {};
+	std::array<size_t, 2> lengths = {};
+	std::array<std::atomic<BufferState>, 2> states = {};
+	std::atomic<bool> inFlight{false};
+	std::atomic<uint8_t> sending{NO_BUFFER};
+
+public:
+	/*
+	 * startTransfer(data, len) starts the DMA transfer, e.g. HAL_UART_Transmit_DMA(),
+	 * and returns false when it could not be started; the frame is retried at the next poll().
+	 */
+	TransmitQueue(Manager &manager, Callback<bool(const uint8_t*, size_t)> startTransfer)
+		:manager(manager),startTransfer(startTransfer){
+		states[0].store(BufferState::Empty, std::memory_order_relaxed);
+		states[1].store(BufferState::Empty, std::memory_order_relaxed);
+	}
+
+	static constexpr uint8_t getFrameLen(COMMAND_ID id){
+		return Manager::getFrameLen(id);
+	}
+
+	/*
+	 * Queue id. Returns false when id is not valid.
+	 */
+	bool push(COMMAND_ID id, TransmitPriority priority){
+		if(static_cast<uint8_t>(id) >= ID_COUNT || static_cast<uint8_t>(priority) >= static_cast<uint8_t>(TransmitPriority::Last)){
+			return false;
+		}
+		queues[static_cast<uint8_t>(priority)].pushBack(id);
+		poll();
+		return true;
+	}
+
+	/*
+	 * Queue id as telemetry. Lets TelemetryScheduler send through the queue.
+	 */
+	void transmit(const COMMAND_ID id){
+		push(id, TransmitPriority::Telemetry);
+	}
+
+	/*
+	 * Stage the next frame and start it when the line is idle. Call it from the main loop.
+	 */
+	void poll(){
+		if(staged != NO_BUFFER){
+			if(states[staged].load(std::memory_order_acquire) != BufferState::Ready){
+				//taken by the DMA interrupt
+				staged = NO_BUFFER;
+			}else if(hasMoreUrgent(stagedPriority)){
+				BufferState expected = BufferState::Ready;
+				if(states[staged].compare_exchange_strong(expected, BufferState::Empty, std::memory_order_acq_rel)){
+					queues[static_cast<uint8_t>(stagedPriority)].pushFront(stagedId);
+				}
+				staged = NO_BUFFER;
+			}
+		}
+		if(staged == NO_BUFFER){
+			stage();
+		}
+		tryStart();
+	}
+
+	/*
+	 * Call from the DMA transfer complete interrupt. Starts the staged frame if there is one.
+	 */
+	void onTransferComplete(){
+		const uint8_t sent = sending.exchange(NO_BUFFER, std::memory_order_acq_rel);
+		if(sent == NO_BUFFER){
+			return;
+		}
+		states[sent].store(BufferState::Empty, std::memory_order_release);
+		inFlight.store(false, std::memory_order_release);
+		tryStart();
+	}
+
+	bool busy() const {
+		return inFlight.load(std::memory_order_acquire);
+	}
+
+	bool idle() const {
+		if(busy() || staged != NO_BUFFER){
+			return false;
+		}
+		for(const IdQueue &queue : queues){
+			if(!queue.empty()){
+				return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	bool hasMoreUrgent(TransmitPriority priority) const {
+		for(uint8_t p = 0; p < static_cast<uint8_t>(priority); p++){
+			if(!queues[p].empty()){
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void stage(){
+		uint8_t buffer = NO_BUFFER;
+		for(uint8_t b = 0; b < buffers.size(); b++){
+			if(states[b].load(std::memory_order_acquire) == BufferState::Empty){
+				buffer = b;
+				break;
+			}
+		}
+		if(buffer == NO_BUFFER){
+			return;
+		}
+		for(uint8_t p = 0; p < queues.size(); p++){
+			while(!queues[p].empty()){
+				const COMMAND_ID id = queues[p].pop();
+				states[buffer].store(BufferState::Filling, std::memory_order_relaxed);
+				lengths[buffer] = manager.constructTransmitFrameInto(id, buffers[buffer].data(), buffers[buffer].size());
+				if(lengths[buffer] == 0){
+					//no handler; drop it
+					states[buffer].store(BufferState::Empty, std::memory_order_relaxed);
+					continue;
+				}
+				staged = buffer;
+				stagedPriority = static_cast<TransmitPriority>(p);
+				stagedId = id;
+				states[buffer].store(BufferState::Ready, std::memory_order_release);
+				return;
+			}
+		}
+	}
+
+	/*
+	 * Start a Ready buffer unless a transfer is in flight. Runs in both contexts;
+	 * inFlight decides which one starts, and the recheck closes the window in which
+	 * the other context made a buffer Ready after the scan.
+	 */
+	void tryStart(){
+		while(true){
+			bool expected = false;
+			if(!inFlight.compare_exchange_strong(expected, true, std::memory_order_acq_rel)){
+				return;
+			}
+			for(uint8_t b = 0; b < buffers.size(); b++){
+				BufferState ready = BufferState::Ready;
+				if(states[b].compare_exchange_strong(ready, BufferState::Sending, std::memory_order_acq_rel)){
+					sending.store(b, std::memory_order_release);
+					if(!startTransfer(buffers[b].data(), lengths[b])){
+						sending.store(NO_BUFFER, std::memory_order_release);
+						states[b].store(BufferState::Ready, std::memory_order_release);
+						inFlight.store(false, std::memory_order_release);
+					}
+					return;
+				}
+			}
+			inFlight.store(false, std::memory_order_release);
+			if(states[0].load(std::memory_order_acquire) != BufferState::Ready &&
+			   states[1].load(std::memory_order_acquire) != BufferState::Ready){
+				return;
+			}
+		}
+	}
+};
+
+} /* namespace command */
+
+#endif /* COMMAND_INC_TRANSMITQUEUE_HPP_ */
@@ -0,0 +1,107 @@
+/*
+ * SerialTransport.cpp
+ *
+ *  Created on: Mar 15, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#include "./Inc/SerialTransport.hpp"
+
+#if defined(__linux__)
+
+#include <cstdlib>
+#include <fcntl.h>
+#include <termios.h>
+
+namespace command{
+	namespace {
+		bool toSpeed(uint32_t baud, speed_t &speed){
+			switch(baud){
+			case 9600: speed = B9600; return true;
+			case 19200: speed = B19200; return true;
+			case 38400: speed = B38400; return true;
+			case 57600: speed = B57600; return true;
+			case 115200: speed = B115200; return true;
+			case 230400: speed = B230400; return true;
+			case 460800: speed = B460800; return true;
+			case 921600: speed = B921600; return true;
+			case 1000000: speed = B1000000; return true;
+			case 2000000: speed = B2000000; return true;
+			case 3000000: speed = B3000000; return true;
+			case 4000000: speed = B4000000; return true;
+			default: return false;
+			}
+		}
+
+		//8N1 without flow control or any processing; read() returns what is there.
+		//VMIN 1 so that a non-blocking read() of nothing fails with EAGAIN instead of returning 0 like end of file
+		bool makeRaw(int fd, const speed_t* speed){
+			termios tio;
+			if(tcgetattr(fd, &tio) != 0){
+				return false;
+			}
+			cfmakeraw(&tio);
+			tio.c_cflag |= CLOCAL | CREAD;
+			tio.c_cflag &= ~CRTSCTS;
+			tio.c_cc[VMIN] = 1;
+			tio.c_cc[VTIME] = 0;
+			if(speed != nullptr && (cfsetispeed(&tio, *speed) != 0 || cfsetospeed(&tio, *speed) != 0)){
+				return false;
+			}
+			return tcsetattr(fd, TCSANOW, &tio) == 0;
+		}
+	}
+
+	bool SerialPort::open(const char* path, uint32_t baud){
+		close();
+		speed_t speed;
+		if(!toSpeed(baud, speed)){
+			return false;
+		}
+		descriptor = ::open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+		if(descriptor < 0){
+			return false;
+		}
+		if(!makeRaw(descriptor, &speed)){
+			close();
+			return false;
+		}
+		//drop what the device buffered before it was opened
+		tcflush(descriptor, TCIOFLUSH);
+		return true;
+	}
+
+	bool SerialPort::openPty(SerialPort &other){
+		close();
+		other.close();
+		const int master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+		if(master < 0){
+			return false;
+		}
+		char name[64];
+		int slave = -1;
+		if(grantpt(master) == 0 && unlockpt(master) == 0 && ptsname_r(master, name, sizeof(name)) == 0){
+			slave = ::open(name, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+		}
+		//the line discipline is on the slave side
+		if(slave < 0 || !makeRaw(slave, nullptr)){
+			if(slave >= 0){
+				::close(slave);
+			}
+			::close(master);
+			return false;
+		}
+		descriptor = master;
+		other.descriptor = slave;
+		return true;
+	}
+
+	void SerialPort::close(){
+		if(descriptor >= 0){
+			::close(descriptor);
+			descriptor = -1;
+		}
+	}
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,237 @@
+/*
+ * TelemetryColumns.cpp
+ *
+ *  Created on: Mar 13, 2026
+ *      Author: OHYA Satoshi
+ */
+
+#include "./Inc/TelemetryColumns.hpp"
+
+#if defined(__linux__)
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace command{
+	namespace {
+		const char* const idNames[] = {
+			"ConnectionCheck", "SensorStatus", "Request", "Goal", "Altitude", "Mode",
+			"AbsoluteNavigationLog", "RelativeNavigationLog",
+			"ServoConfig_prachuteLeft", "ServoConfig_prachuteRight", "ServoConfig_stabilizer",
+			"GPS", "IMU", "DecentLog", "ImuCompact"
+		};
+		static_assert(sizeof(idNames) / sizeof(idNames[0]) == static_cast<size_t>(COMMAND_ID::Last), "a name for every COMMAND_ID");
+
+		constexpr size_t ID_COUNT = static_cast<size_t>(COMMAND_ID::Last);
+
+		template<COMMAND_ID Id, typename Value, typename Codec = wire::Schema<Value>>
+		struct Table : columnar::TableColumns<Codec, Value> {
+			static constexpr COMMAND_ID id = Id;
+
+			static void decode(const uint8_t* bodies, size_t rows, void* const* columns, const wire::ImuFullScale &){
+				columnar::TableColumns<Codec, Value>::decode(bodies, rows, columns);
+			}
+		};
+
+		// ImuCompact is decoded with the full scale of the link.
+		template<>
+		struct Table<COMMAND_ID::ImuCompact, CommandDataType::IMU, wire::CompactImu>
+			: columnar::TableColumns<wire::CompactImu, CommandDataType::IMU, wire::ImuFullScale> {
+			static constexpr COMMAND_ID id = COMMAND_ID::ImuCompact;
+		};
+
+		// Commands with a CommandDataType schema, in table order.
+		using Tables = std::tuple<
+			Table<COMMAND_ID::SensorStatus, CommandDataType::SensorStatus>,
+			Table<COMMAND_ID::Goal, CommandDataType::Coordinates>,
+			Table<COMMAND_ID::Altitude, CommandDataType::Altitude>,
+			Table<COMMAND_ID::AbsoluteNavigationLog, CommandDataType::AbsoluteNavigation>,
+			Table<COMMAND_ID::RelativeNavigationLog, CommandDataType::RelativeNavigation>,
+			Table<COMMAND_ID::ServoConfig_prachuteLeft, CommandDataType::ServoConfig>,
+			Table<COMMAND_ID::ServoConfig_prachuteRight, CommandDataType::ServoConfig>,
+			Table<COMMAND_ID::ServoConfig_stabilizer, CommandDataType::ServoConfig>,
+			Table<COMMAND_ID::GPS, CommandDataType::GPS>,
+			Table<COMMAND_ID::IMU, CommandDataType::IMU>,
+			Table<COMMAND_ID::DecentLog, CommandDataType::DecentLog>,
+			Table<COMMAND_ID::ImuCompact, CommandDataType::IMU, wire::CompactImu>
+		>;
+
+		template<typename F, size_t... I>
+		void forEachTable(F f, std::index_sequence<I...>){
+			(f(std::tuple_element_t<I, Tables>(), I), ...);
+		}
+		template<typename F>
+		void forEachTable(F f){
+			forEachTable(f, std::make_index_sequence<std::tuple_size<Tables>::value>());
+		}
+
+		size_t alignColumn(size_t offset){
+			return (offset + columnar::COLUMN_ALIGN - 1) / columnar::COLUMN_ALIGN * columnar::COLUMN_ALIGN;
+		}
+	}
+
+	bool TelemetryColumns::write(const FlightLogReader &log, const char* path, const wire::ImuFullScale &scale){
+		constexpr size_t tableCount = std::tuple_size<Tables>::value;
+
+		//first pass: rows of each table
+		std::array<uint8_t, ID_COUNT> bodySize = {};
+		forEachTable([&](auto table, size_t){
+			bodySize[static_cast<size_t>(table.id)] = table.bodySize;
+		});
+		std::array<uint64_t, ID_COUNT> rows = {};
+		uint64_t skipped = 0;
+		const auto accepts = [&](const flightlog::Record &record){
+			const size_t id = static_cast<size_t>(record.id);
+			return id < ID_COUNT && bodySize[id] != 0 && record.body.size() == bodySize[id];
+		};
+		log.forEachRecord([&](const flightlog::Record &record){
+			if(accepts(record)){
+				rows[static_cast<size_t>(record.id)]++;
+			}else{
+				skipped++;
+			}
+			return true;
+		});
+
+		//layout: a time column, then the columns of the schema
+		std::vector<columnar::TableEntry> tables(tableCount);
+		std::vector<columnar::ColumnEntry> columns;
+		forEachTable([&](auto table, size_t t){
+			columnar::TableEntry &entry = tables[t];
+			entry = {};
+			std::snprintf(entry.name, columnar::NAME_SIZE, "%s", idNames[static_cast<size_t>(table.id)]);
+			entry.id = static_cast<uint8_t>(table.id);
+			entry.firstColumn = static_cast<uint32_t>(columns.size());
+			entry.columnCount = static_cast<uint32_t>(1 + table.columns);
+			entry.rows = rows[static_cast<size_t>(table.id)];
+			columns.resize(columns.size() + entry.columnCount, columnar::ColumnEntry());
+			columnar::ColumnEntry* first = &columns[entry.firstColumn];
+			columnar::detail::describeColumn<int64_t>(first[0], "time", "");
+			table.describe(first + 1);
+			for(size_t c = 0; c < entry.columnCount; c++){
+				first[c].table = static_cast<uint32_t>(t);
+			}
+		});
+		size_t fileSize = sizeof(columnar::FileHeader) + tables.size() * sizeof(columnar::TableEntry) +
+		                  columns.size() * sizeof(columnar::ColumnEntry);
+		for(columnar::ColumnEntry &column : columns){
+			fileSize = alignColumn(fileSize);
+			column.offset = fileSize;
+			column.bytes = tables[column.table].rows * column.elementSize;
+			fileSize += column.bytes;
+		}
+
+		const int descriptor = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if(descriptor < 0){
+			return false;
+		}
+		void* mapped = MAP_FAILED;
+		if(ftruncate(descriptor, static_cast<off_t>(fileSize)) == 0){
+			mapped = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+		}
+		if(mapped == MAP_FAILED){
+			::close(descriptor);
+			return false;
+		}
+		uint8_t* file = static_cast<uint8_t*>(mapped);
+
+		columnar::FileHeader header = {};
+		header.magic = columnar::FILE_MAGIC;
+		header.version = columnar::VERSION;
+		header.tableCount = static_cast<uint32_t>(tables.size());
+		header.columnCount = static_cast<uint32_t>(columns.size());
+		header.skipped = skipped;
+		uint8_t* cursor = file;
+		std::memcpy(cursor, &header, sizeof(header));
+		cursor += sizeof(header);
+		std::memcpy(cursor, tables.data(), tables.size() * sizeof(columnar::TableEntry));
+		cursor += tables.size() * sizeof(columnar::TableEntry);
+		std::memcpy(cursor, columns.data(), columns.size() * sizeof(columnar::ColumnEntry));
+
+		//second pass: times straight into their columns, bodies back to back for the decoders
+		std::array<std::vector<uint8_t>, ID_COUNT> bodies;
+		std::array<int64_t*, ID_COUNT> times = {};
+		std::array<uint64_t, ID_COUNT> filled = {};
+		for(const columnar::TableEntry &table : tables){
+			bodies[table.id].resize(table.rows * bodySize[table.id]);
+			times[table.id] = reinterpret_cast<int64_t*>(file + columns[table.firstColumn].offset);
+		}
+		log.forEachRecord([&](const flightlog::Record &record){
+			if(accepts(record)){
+				const size_t id = static_cast<size_t>(record.id);
+				const size_t row = filled[id]++;
+				times[id][row] = record.time;
+				record.body.copy(0, bodies[id].data() + row * bodySize[id], bodySize[id]);
+			}
+			return true;
+		});
+
+		forEachTable([&](auto table, size_t t){
+			using T = decltype(table);
+			const columnar::TableEntry &entry = tables[t];
+			std::array<void*, T::columns> out;
+			for(size_t c = 0; c < T::columns; c++){
+				out[c] = file + columns[entry.firstColumn + 1 + c].offset;
+			}
+			T::decode(bodies[entry.id].data(), entry.rows, out.data(), scale);
+		});
+
+		munmap(mapped, fileSize);
+		return ::close(descriptor) == 0;
+	}
+
+	bool TelemetryColumns::open(const char* path){
+		close();
+		fd = ::open(path, O_RDONLY | O_CLOEXEC);
+		if(fd < 0){
+			return false;
+		}
+		struct stat st;
+		if(fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(columnar::FileHeader)){
+			close();
+			return false;
+		}
+		mapSize = static_cast<size_t>(st.st_size);
+		void* mapped = mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+		if(mapped == MAP_FAILED){
+			close();
+			return false;
+		}
+		map = static_cast<const uint8_t*>(mapped);
+
+		const columnar::FileHeader &h = header();
+		const size_t entries = sizeof(columnar::FileHeader) + size_t(h.tableCount) * sizeof(columnar::TableEntry) +
+		                       size_t(h.columnCount) * sizeof(columnar::ColumnEntry);
+		bool valid = h.magic == columnar::FILE_MAGIC && h.version == columnar::VERSION && entries <= mapSize;
+		for(size_t i = 0; valid && i < h.tableCount; i++){
+			valid = size_t(table(i).firstColumn) + table(i).columnCount <= h.columnCount;
+		}
+		for(size_t i = 0; valid && i < h.columnCount; i++){
+			const columnar::ColumnEntry &c = column(i);
+			valid = c.table < h.tableCount && c.offset % columnar::COLUMN_ALIGN == 0 && c.offset <= mapSize &&
+			        c.bytes <= mapSize - c.offset && c.bytes == table(c.table).rows * c.elementSize;
+		}
+		if(!valid){
+			close();
+			return false;
+		}
+		return true;
+	}
+
+	void TelemetryColumns::close(){
+		if(map != nullptr){
+			munmap(const_cast<uint8_t*>(map), mapSize);
+			map = nullptr;
+		}
+		mapSize = 0;
+		if(fd >= 0){
+			::close(fd);
+			fd = -1;
+		}
+	}
+}
+
+#endif /* __linux__ */
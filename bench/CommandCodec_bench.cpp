@@ -0,0 +1,359 @@
+/*
+ * Cost per frame of the handler codecs, frame construction and the receive parser.
+ *
+ * Build on the host, e.g.
+ *   g++ -std=c++17 -O2 -I. bench/CommandCodec_bench.cpp *.cpp -o codec_bench
+ *   ./codec_bench [results.csv]
+ * A table is printed and every row is also written as CSV (default codec_bench.csv):
+ *   group,name,ns_per_frame,frames_per_s,allocs_per_frame
+ * allocs_per_frame counts operator new calls inside the timed loop.
+ */
+#include "../Inc/CommandManager.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace command;
+
+namespace {
+
+size_t allocationCount = 0;
+
+} // namespace
+
+void *operator new(size_t size) {
+    allocationCount++;
+    if (void *p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+const size_t iterations = 200000;
+const size_t streamRounds = 2000;
+
+volatile uint32_t sink;
+
+struct Result {
+    const char *group;
+    std::string name;
+    double ns;
+    double allocs;
+};
+
+std::vector<Result> results;
+
+void report(const char *group, const std::string &name, double ns, double allocs) {
+    results.push_back({group, name, ns, allocs});
+    std::printf("%-10s %-36s %9.1f ns/frame %12.0f frames/s %6.2f allocs/frame\n", group, name.c_str(), ns, 1e9 / ns,
+                allocs);
+}
+
+/*
+ * Run f(i) for i in [0, count) and report the mean cost per frame when one call handles framesPerCall frames.
+ */
+template <typename F>
+void measure(const char *group, const std::string &name, size_t count, size_t framesPerCall, F f) {
+    const size_t allocsBefore = allocationCount;
+    const auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        f(i);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const size_t allocs = allocationCount - allocsBefore;
+    const double frames = double(count) * framesPerCall;
+    report(group, name, std::chrono::duration<double, std::nano>(end - begin).count() / frames, allocs / frames);
+}
+
+struct BenchConfig : DefaultManagerConfig {
+    static constexpr size_t rxCapacity = 4096;
+};
+using Manager = BasicCommandManager<BenchConfig>;
+
+/*
+ * One handler of every command, registered to a manager.
+ */
+struct Handlers {
+    ConnectionCheck connectionCheck;
+    SensorStatus sensorStatus;
+    Request request{COMMAND_ID::Mode};
+    Goal goal;
+    Altitude altitude;
+    Mode mode;
+    AbsoluteNavigation absoluteNavigation;
+    RelativeNavigation relativeNavigation;
+    ServoConfig_prachuteLeft servoLeft;
+    ServoConfig_prachuteRight servoRight;
+    ServoConfig_stabilizer servoStabilizer;
+    Gps gps;
+    Imu imu;
+    DecentLog decentLog;
+    ImuCompact imuCompact;
+
+    struct Entry {
+        const char *name;
+        COMMAND_ID id;
+        Base *handler;
+    };
+
+    std::vector<Entry> entries() {
+        return {
+            {"ConnectionCheck", COMMAND_ID::ConnectionCheck, &connectionCheck},
+            {"SensorStatus", COMMAND_ID::SensorStatus, &sensorStatus},
+            {"Request", COMMAND_ID::Request, &request},
+            {"Goal", COMMAND_ID::Goal, &goal},
+            {"Altitude", COMMAND_ID::Altitude, &altitude},
+            {"Mode", COMMAND_ID::Mode, &mode},
+            {"AbsoluteNavigation", COMMAND_ID::AbsoluteNavigationLog, &absoluteNavigation},
+            {"RelativeNavigation", COMMAND_ID::RelativeNavigationLog, &relativeNavigation},
+            {"ServoConfig_prachuteLeft", COMMAND_ID::ServoConfig_prachuteLeft, &servoLeft},
+            {"ServoConfig_prachuteRight", COMMAND_ID::ServoConfig_prachuteRight, &servoRight},
+            {"ServoConfig_stabilizer", COMMAND_ID::ServoConfig_stabilizer, &servoStabilizer},
+            {"Gps", COMMAND_ID::GPS, &gps},
+            {"Imu", COMMAND_ID::IMU, &imu},
+            {"DecentLog", COMMAND_ID::DecentLog, &decentLog},
+            {"ImuCompact", COMMAND_ID::ImuCompact, &imuCompact},
+        };
+    }
+
+    void registerTo(Manager &manager) {
+        for (const Entry &entry : entries()) {
+            manager[entry.id] = entry.handler;
+        }
+    }
+};
+
+void benchHandlers() {
+    Handlers handlers;
+    uint8_t body[255];
+    for (const Handlers::Entry &entry : handlers.entries()) {
+        const uint8_t len = Manager::getFrameLen(entry.id) - Manager::FRAME_OVERHEAD;
+        measure("transmit", entry.name, iterations, 1, [&](size_t) { sink = entry.handler->transmit(body, len); });
+    }
+    for (const Handlers::Entry &entry : handlers.entries()) {
+        const uint8_t len = entry.handler->transmit(body, sizeof(body));
+        const FrameView view(body, len);
+        measure("onReceive", entry.name, iterations, 1,
+                [&](size_t) { sink = static_cast<uint32_t>(entry.handler->onReceive(view)); });
+    }
+}
+
+void benchFrameConstruction() {
+    Handlers handlers;
+    Manager manager;
+    handlers.registerTo(manager);
+    std::array<uint8_t, Manager::MAX_FRAME_LEN> buffer;
+    for (const Handlers::Entry &entry : handlers.entries()) {
+        if (entry.id != COMMAND_ID::Mode && entry.id != COMMAND_ID::Goal && entry.id != COMMAND_ID::IMU) {
+            continue;
+        }
+        measure("construct", std::string("vector ") + entry.name, iterations, 1,
+                [&](size_t) { sink = manager.constructTransmitFrame(entry.id).size(); });
+        measure("construct", std::string("buffer ") + entry.name, iterations, 1,
+                [&](size_t) { sink = manager.constructTransmitFrameInto(entry.id, buffer.data(), buffer.size()); });
+    }
+}
+
+/*
+ * Frames of every command, back to back, up to half of the receive ring.
+ */
+std::vector<uint8_t> cleanStream(Manager &sender, Handlers &handlers, size_t &frames) {
+    std::vector<uint8_t> stream;
+    frames = 0;
+    while (true) {
+        for (const Handlers::Entry &entry : handlers.entries()) {
+            const std::vector<uint8_t> frame = sender.constructTransmitFrame(entry.id);
+            if (stream.size() + frame.size() > BenchConfig::rxCapacity / 2) {
+                return stream;
+            }
+            stream.insert(stream.end(), frame.begin(), frame.end());
+            frames++;
+        }
+    }
+}
+
+/*
+ * Parse frame by frame with processReceive() until rBuffer stops shrinking.
+ * processReceive() also returns COMMAND_ID::Last for a rejected frame, so its result can not end the loop.
+ */
+void drain(Manager &manager) {
+    size_t before;
+    do {
+        before = manager.receiveRing().readable();
+        manager.processReceive();
+    } while (manager.receiveRing().readable() != before);
+}
+
+uint32_t dispatchedFrames(const Manager &manager) {
+    const LinkStatistics stats = manager.statistics();
+    uint32_t frames = 0;
+    for (uint32_t count : stats.frames) {
+        frames += count;
+    }
+    return frames;
+}
+
+/*
+ * Time rounds of f and check with the link statistics that every frame of every round was dispatched.
+ */
+template <typename F>
+void measureStream(Manager &manager, const char *name, size_t framesPerRound, F f) {
+    manager.resetStatistics();
+    measure("parse", name, streamRounds, framesPerRound, f);
+    if (dispatchedFrames(manager) != streamRounds * framesPerRound) {
+        std::fprintf(stderr, "%s: %u of %zu frames dispatched\n", name, dispatchedFrames(manager),
+                     streamRounds * framesPerRound);
+        std::exit(1);
+    }
+}
+
+void benchStreams() {
+    Handlers handlers;
+    Manager manager;
+    handlers.registerTo(manager);
+    size_t frames = 0;
+    const std::vector<uint8_t> clean = cleanStream(manager, handlers, frames);
+
+    // Noise between frames: a false start with an invalid ID, then random bytes without START_BYTE.
+    // (A false start of a valid ID may swallow the next frame, which would make the frame count vary.)
+    std::vector<uint8_t> noisy;
+    size_t noisyFrames = 0;
+    uint32_t seed = 1;
+    for (size_t pos = 0; pos < clean.size();) {
+        const size_t len = Manager::getFrameLen(static_cast<COMMAND_ID>(clean[pos + 1]));
+        noisy.insert(noisy.end(), clean.begin() + pos, clean.begin() + pos + len);
+        pos += len;
+        noisyFrames++;
+        for (int i = 0; i < 6; i++) {
+            seed = seed * 1103515245 + 12345;
+            const uint8_t noise = static_cast<uint8_t>(seed >> 16);
+            noisy.push_back(i == 0 ? 's' : i == 1 ? 0xf0 : noise == 's' ? 'x' : noise);
+        }
+        if (noisy.size() + Manager::MAX_FRAME_LEN + 6 > BenchConfig::rxCapacity / 2) {
+            break;
+        }
+    }
+
+    measureStream(manager, "processReceive clean", frames, [&](size_t) {
+        manager.receive(clean.begin(), clean.end());
+        drain(manager);
+    });
+    measureStream(manager, "processReceive noisy", noisyFrames, [&](size_t) {
+        manager.receive(noisy.begin(), noisy.end());
+        drain(manager);
+    });
+    // The clean stream in 1 to 7 byte pieces, parsed after each piece as from a UART interrupt.
+    measureStream(manager, "processReceive fragmented", frames, [&](size_t round) {
+        size_t piece = 1 + round % 7;
+        for (size_t pos = 0; pos < clean.size();) {
+            const size_t end = std::min(clean.size(), pos + piece);
+            manager.receive(clean.begin() + pos, clean.begin() + end);
+            drain(manager);
+            pos = end;
+            piece = piece % 7 + 1;
+        }
+    });
+    measureStream(manager, "processReceiveAll clean", frames, [&](size_t) {
+        manager.receive(clean.begin(), clean.end());
+        manager.processReceiveAll();
+    });
+}
+
+// Keep the compiler from removing an object which is built but not otherwise used.
+template <typename T>
+void escape(T *object) {
+    asm volatile("" : : "g"(object) : "memory");
+}
+
+/*
+ * Handler callbacks: Callback against std::function with the same lambda.
+ */
+void benchCallback() {
+    uint32_t total = 0;
+    uint32_t calls = 0;
+    uint32_t last = 0;
+    auto lambda = [&total, &calls](uint8_t value) {
+        total += value;
+        calls++;
+    };
+    // Three references: beyond the in-place storage of std::function in libstdc++ and of the default Callback.
+    auto wide = [&total, &calls, &last](uint8_t value) {
+        total += value;
+        calls++;
+        last = value;
+    };
+
+    Callback<void(uint8_t)> callback(lambda);
+    std::function<void(uint8_t)> function(lambda);
+    escape(&callback);
+    escape(&function);
+    measure("callback", "call Callback", iterations * 10, 1, [&](size_t i) { callback(static_cast<uint8_t>(i)); });
+    measure("callback", "call std::function", iterations * 10, 1, [&](size_t i) { function(static_cast<uint8_t>(i)); });
+
+    // Bind and call once, as when a handler is reconfigured at runtime.
+    measure("callback", "bind Callback", iterations, 1, [&](size_t i) {
+        Callback<void(uint8_t)> bound(lambda);
+        escape(&bound);
+        bound(static_cast<uint8_t>(i));
+    });
+    measure("callback", "bind std::function", iterations, 1, [&](size_t i) {
+        std::function<void(uint8_t)> bound(lambda);
+        escape(&bound);
+        bound(static_cast<uint8_t>(i));
+    });
+    measure("callback", "bind Callback 3 refs", iterations, 1, [&](size_t i) {
+        Callback<void(uint8_t), 3 * sizeof(void *)> bound(wide);
+        escape(&bound);
+        bound(static_cast<uint8_t>(i));
+    });
+    measure("callback", "bind std::function 3 refs", iterations, 1, [&](size_t i) {
+        std::function<void(uint8_t)> bound(wide);
+        escape(&bound);
+        bound(static_cast<uint8_t>(i));
+    });
+    sink = total + calls + last;
+}
+
+bool writeCsv(const char *path) {
+    std::FILE *file = std::fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+    std::fprintf(file, "group,name,ns_per_frame,frames_per_s,allocs_per_frame\n");
+    for (const Result &result : results) {
+        std::fprintf(file, "%s,\"%s\",%.2f,%.0f,%.3f\n", result.group, result.name.c_str(), result.ns, 1e9 / result.ns,
+                     result.allocs);
+    }
+    return std::fclose(file) == 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const char *path = argc > 1 ? argv[1] : "codec_bench.csv";
+    results.reserve(128);
+
+    benchHandlers();
+    benchFrameConstruction();
+    benchStreams();
+    benchCallback();
+
+    if (!writeCsv(path)) {
+        std::fprintf(stderr, "can not write %s\n", path);
+        return 1;
+    }
+    std::printf("results written to %s\n", path);
+    return 0;
+}
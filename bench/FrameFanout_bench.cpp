@@ -0,0 +1,176 @@
+/*
+ * Fan-out benchmark: IMU commands published to local UDP or Unix datagram subscribers which a reader thread drains.
+ * Reports the publish rate, the sendmmsg() calls per batch and what every subscriber received or lost.
+ * Use it to check that the ground station keeps up with the telemetry rate for the planned consumers.
+ *
+ * Build on the host, e.g.
+ *   g++ -std=c++17 -O2 -I. bench/FrameFanout_bench.cpp *.cpp -pthread -o frame_fanout
+ *   ./frame_fanout --subscribers=12 --frames=1000000
+ *   ./frame_fanout --subscribers=12 --rate=2000 --frames=20000 --unix=1
+ *
+ * Options (--name=value):
+ *   frames       commands to publish (1000000)
+ *   subscribers  number of subscribers, up to 16 (12)
+ *   unix         1 for Unix datagram sockets instead of UDP (0)
+ *   rate         commands per second, 0 for as fast as possible (0)
+ *   flush        commands between two flush() calls, like the commands of one processReceiveAll() (8)
+ */
+#include "../Inc/FrameFanout.hpp"
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <netinet/in.h>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace command;
+
+namespace {
+
+struct Options {
+    size_t frames = 1000000;
+    size_t subscribers = 12;
+    bool unix = false;
+    double rate = 0;
+    size_t flush = 8;
+};
+
+bool parse(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const size_t eq = arg.find('=');
+        if (arg.compare(0, 2, "--") != 0 || eq == std::string::npos) {
+            return false;
+        }
+        const std::string name = arg.substr(2, eq - 2);
+        const std::string value = arg.substr(eq + 1);
+        if (name == "frames") {
+            options.frames = std::stoul(value);
+        } else if (name == "subscribers") {
+            options.subscribers = std::stoul(value);
+        } else if (name == "unix") {
+            options.unix = std::stoi(value) != 0;
+        } else if (name == "rate") {
+            options.rate = std::stod(value);
+        } else if (name == "flush") {
+            options.flush = std::stoul(value);
+        } else {
+            return false;
+        }
+    }
+    return options.subscribers > 0 && options.subscribers <= FrameFanout::MAX_SUBSCRIBERS && options.flush > 0;
+}
+
+// A bound datagram socket; subscribes the fanout to itself.
+int bindSubscriber(FrameFanout &fanout, bool unix, size_t index) {
+    const int fd = socket(unix ? AF_UNIX : AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    const int size = 4 << 20;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    if (unix) {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        std::snprintf(address.sun_path, sizeof(address.sun_path), "/tmp/frame_fanout_bench_%d_%zu.sock", getpid(), index);
+        unlink(address.sun_path);
+        if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+            fanout.subscribeUnix(address.sun_path) == FrameFanout::NO_SUBSCRIBER) {
+            return -1;
+        }
+        return fd;
+    }
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(address);
+    if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        getsockname(fd, reinterpret_cast<sockaddr *>(&address), &len) != 0 ||
+        fanout.subscribeUdp(ntohs(address.sin_port)) == FrameFanout::NO_SUBSCRIBER) {
+        return -1;
+    }
+    return fd;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        std::fprintf(stderr, "usage: %s [--frames=N] [--subscribers=1..16] [--unix=0|1] [--rate=N] [--flush=N]\n", argv[0]);
+        return 2;
+    }
+
+    FrameFanout fanout;
+    std::vector<int> fds;
+    const int epoll = epoll_create1(EPOLL_CLOEXEC);
+    for (size_t i = 0; i < options.subscribers; i++) {
+        const int fd = bindSubscriber(fanout, options.unix, i);
+        if (fd < 0) {
+            std::fprintf(stderr, "can not bind subscriber %zu\n", i);
+            return 1;
+        }
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u64 = i;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event);
+        fds.push_back(fd);
+    }
+
+    // the consumers: one thread drains every subscriber
+    std::vector<uint64_t> received(options.subscribers, 0);
+    std::atomic<bool> running{true};
+    std::thread reader([&]() {
+        uint8_t buffer[FrameFanout::MAX_DATAGRAM];
+        epoll_event events[16];
+        while (running.load(std::memory_order_relaxed)) {
+            const int ready = epoll_wait(epoll, events, 16, 10);
+            for (int i = 0; i < ready; i++) {
+                const size_t index = events[i].data.u64;
+                while (recv(fds[index], buffer, sizeof(buffer), MSG_DONTWAIT) > 0) {
+                    received[index]++;
+                }
+            }
+        }
+    });
+
+    uint8_t body[Imu::getDataBodyLen()] = {};
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < options.frames; i++) {
+        if (options.rate > 0) {
+            const auto due = start + std::chrono::nanoseconds(static_cast<int64_t>(i * 1e9 / options.rate));
+            while (std::chrono::steady_clock::now() < due) {
+            }
+        }
+        body[0] = static_cast<uint8_t>(i);
+        fanout.publish(COMMAND_ID::IMU, FrameView(body, sizeof(body)));
+        if ((i + 1) % options.flush == 0) {
+            fanout.flush();
+        }
+    }
+    fanout.flush();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    running.store(false);
+    reader.join();
+
+    std::printf("published %zu commands in %.3f s: %.0f commands/s, %.0f datagrams/s, %.2f commands per sendmmsg()\n",
+                options.frames, seconds, options.frames / seconds, options.frames * options.subscribers / seconds,
+                static_cast<double>(options.frames * options.subscribers) / fanout.sends());
+    for (size_t i = 0; i < options.subscribers; i++) {
+        const FrameFanout::SubscriberStatistics stats = fanout.statistics(i);
+        std::printf("subscriber %2zu sent %llu dropped %llu received %llu\n", i, static_cast<unsigned long long>(stats.sent),
+                    static_cast<unsigned long long>(stats.dropped), static_cast<unsigned long long>(received[i]));
+        close(fds[i]);
+        if (options.unix) {
+            char path[108];
+            std::snprintf(path, sizeof(path), "/tmp/frame_fanout_bench_%d_%zu.sock", getpid(), i);
+            unlink(path);
+        }
+    }
+    close(epoll);
+    return 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * Cost per frame of each integrity check.
+ *
+ * Build on the host, e.g.
+ *   g++ -std=c++17 -O2 -I. bench/FrameIntegrity_bench.cpp -o integrity_bench
+ * Add -DCOMMAND_CRC_USE_HARDWARE=0 to measure the table-driven CRC-32C only.
+ */
+#include "../Inc/FrameIntegrity.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace command;
+
+namespace {
+
+// ID + body lengths of the shortest, a typical and the longest command.
+const size_t frameLengths[] = {2, 17, 37};
+const size_t iterations = 2000000;
+
+volatile uint32_t sink;
+
+template <typename Integrity>
+void run(const char *name) {
+    for (size_t len : frameLengths) {
+        std::vector<uint8_t> data(len);
+        for (size_t i = 0; i < len; i++) {
+            data[i] = static_cast<uint8_t>(i * 37 + 11);
+        }
+
+        uint32_t acc = 0;
+        const auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++) {
+            data[0] = static_cast<uint8_t>(i);
+            acc += integrity::compute<Integrity>(FrameView(data.data(), data.size()));
+        }
+        const auto end = std::chrono::steady_clock::now();
+        sink = acc;
+
+        const double ns = std::chrono::duration<double, std::nano>(end - begin).count() / iterations;
+        std::printf("%-14s %3zu bytes %8.2f ns/frame %8.3f ns/byte\n", name, len, ns, ns / len);
+    }
+}
+
+} // namespace
+
+int main() {
+    run<integrity::Sum8>("Sum8");
+    run<integrity::Crc8>("CRC-8");
+    run<integrity::Crc16Ccitt>("CRC-16/CCITT");
+    run<integrity::Crc32c>("CRC-32C");
+#if defined(COMMAND_CRC32C_X86)
+    std::printf("CRC-32C uses SSE4.2: %s\n", integrity::Crc32c::hasHardware() ? "yes" : "no");
+#endif
+    return 0;
+}
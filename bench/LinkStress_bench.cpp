@@ -0,0 +1,437 @@
+/*
+ * Stress harness: a frame stream with radio impairments fed through receive()/processReceiveAll() in chunks.
+ * Reports how many frames were recovered, how many corrupted frames were accepted, and the parser throughput.
+ * Use it to size the receive ring and pick the integrity check and framing before flight.
+ *
+ * Build on the host, e.g.
+ *   g++ -std=c++17 -O2 -I. bench/LinkStress_bench.cpp *.cpp -o link_stress
+ *   ./link_stress --ber=1e-4 --drop=1e-4 --dup=1e-5 --chunk-min=1 --chunk-max=64 --integrity=crc16 --framing=cobs
+ *
+ * Options (--name=value):
+ *   frames       frames to generate (100000)
+ *   seed         random seed (1)
+ *   ber          probability of a bit flip per bit (0)
+ *   drop         probability of dropping a byte (0)
+ *   dup          probability of duplicating a byte (0)
+ *   chunk-min    smallest chunk handed to receive() (1)
+ *   chunk-max    largest chunk handed to receive() (64)
+ *   parse-every  chunks received between two processReceiveAll() calls, to model main loop latency (1)
+ *   integrity    sum8, crc8, crc16 or crc32c (sum8)
+ *   framing      delimited or cobs (delimited)
+ *   rx           receive ring capacity: 256, 1024 or 4096 (256)
+ *   input        parse a captured byte stream instead; recovery is not known then
+ *   output       write the impaired stream, to replay a run with input
+ *
+ * Every dispatched frame is matched in order against the frames sent. A dispatched frame which is not
+ * one of the next 256 frames sent is a false accept. Corruption which turns a frame exactly into one of those
+ * frames can not be told apart from it.
+ */
+#include "../Inc/CommandManager.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace command;
+
+namespace {
+
+struct Options {
+    size_t frames = 100000;
+    uint32_t seed = 1;
+    double ber = 0;
+    double drop = 0;
+    double dup = 0;
+    size_t chunkMin = 1;
+    size_t chunkMax = 64;
+    size_t parseEvery = 1;
+    std::string integrity = "sum8";
+    std::string framing = "delimited";
+    size_t rx = 256;
+    std::string input;
+    std::string output;
+};
+
+/*
+ * Frames sent, in order, and the position of the next expected one.
+ */
+class SentFrames {
+    static constexpr size_t window = 256;
+
+    std::vector<uint8_t> ids;
+    std::vector<size_t> offsets;
+    std::vector<uint8_t> bodies;
+    size_t cursor = 0;
+
+public:
+    size_t recovered = 0;
+    size_t falseAccepts = 0;
+
+    void add(COMMAND_ID id, const uint8_t *body, size_t len) {
+        ids.push_back(static_cast<uint8_t>(id));
+        offsets.push_back(bodies.size());
+        bodies.insert(bodies.end(), body, body + len);
+    }
+
+    size_t size() const {
+        return ids.size();
+    }
+
+    void onFrame(COMMAND_ID id, const FrameView &body) {
+        const size_t end = std::min(ids.size(), cursor + window);
+        for (size_t k = cursor; k < end; k++) {
+            if (ids[k] == static_cast<uint8_t>(id) && equals(k, body)) {
+                recovered++;
+                cursor = k + 1;
+                return;
+            }
+        }
+        falseAccepts++;
+    }
+
+private:
+    bool equals(size_t k, const FrameView &body) const {
+        const size_t len = (k + 1 < offsets.size() ? offsets[k + 1] : bodies.size()) - offsets[k];
+        if (len != body.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < len; i++) {
+            if (bodies[offsets[k] + i] != body[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/*
+ * Handler of any ID with an opaque body: sends body and reports received bodies to SentFrames.
+ */
+class StressHandler : public Base {
+    COMMAND_ID id = COMMAND_ID::Last;
+    SentFrames *sent = nullptr;
+
+public:
+    const uint8_t *body = nullptr;
+    uint8_t bodyLen = 0;
+
+    StressHandler() = default;
+    StressHandler(COMMAND_ID id, SentFrames *sent) : id(id), sent(sent) {}
+
+    COMMAND_ID onReceive(const FrameView &frameBody) override {
+        if (sent != nullptr) {
+            sent->onFrame(id, frameBody);
+        }
+        return COMMAND_ID::Last;
+    }
+    uint8_t transmit(uint8_t *frameBody, uint8_t capacity) override {
+        if (capacity < bodyLen) {
+            return 0;
+        }
+        std::memcpy(frameBody, body, bodyLen);
+        return bodyLen;
+    }
+};
+
+template <class Config>
+struct Link {
+    using Manager = BasicCommandManager<Config>;
+
+    Manager manager;
+    std::array<StressHandler, static_cast<uint8_t>(COMMAND_ID::Last)> handlers;
+
+    explicit Link(SentFrames *sent) {
+        for (uint8_t id = 0; id < handlers.size(); id++) {
+            handlers[id] = StressHandler(static_cast<COMMAND_ID>(id), sent);
+            manager[static_cast<COMMAND_ID>(id)] = &handlers[id];
+        }
+    }
+};
+
+/*
+ * Frames of random IDs with random bodies.
+ */
+template <class Config>
+std::vector<uint8_t> generate(size_t frames, std::mt19937 &rng, SentFrames &sent) {
+    using Manager = typename Link<Config>::Manager;
+    Link<Config> sender(nullptr);
+    std::vector<uint8_t> stream;
+    std::array<uint8_t, Manager::MAX_FRAME_LEN> frame;
+    std::array<uint8_t, Manager::MAX_FRAME_LEN> body;
+    std::uniform_int_distribution<int> idDist(0, static_cast<int>(COMMAND_ID::Last) - 1);
+    std::uniform_int_distribution<int> byteDist(0, 0xff);
+    for (size_t n = 0; n < frames; n++) {
+        const COMMAND_ID id = static_cast<COMMAND_ID>(idDist(rng));
+        StressHandler &handler = sender.handlers[static_cast<uint8_t>(id)];
+        handler.bodyLen = Manager::getFrameLen(id) - Manager::FRAME_OVERHEAD;
+        for (size_t i = 0; i < handler.bodyLen; i++) {
+            body[i] = static_cast<uint8_t>(byteDist(rng));
+        }
+        handler.body = body.data();
+        const size_t len = sender.manager.constructTransmitFrameInto(id, frame.data(), frame.size());
+        stream.insert(stream.end(), frame.begin(), frame.begin() + len);
+        sent.add(id, body.data(), handler.bodyLen);
+    }
+    return stream;
+}
+
+struct Impairments {
+    size_t flippedBits = 0;
+    size_t droppedBytes = 0;
+    size_t duplicatedBytes = 0;
+};
+
+std::vector<uint8_t> impair(const std::vector<uint8_t> &in, const Options &options, std::mt19937 &rng,
+                            Impairments &count) {
+    std::vector<uint8_t> out;
+    out.reserve(in.size() + in.size() / 8);
+    std::bernoulli_distribution drop(options.drop);
+    std::bernoulli_distribution dup(options.dup);
+    // Bit errors are drawn as gaps between errors, so low rates cost nothing per byte.
+    std::geometric_distribution<uint64_t> gap(options.ber > 0 ? options.ber : 1.0);
+    uint64_t nextFlip = options.ber > 0 ? gap(rng) : UINT64_MAX;
+
+    for (size_t i = 0; i < in.size(); i++) {
+        uint8_t byte = in[i];
+        while (nextFlip < (i + 1) * 8) {
+            byte ^= static_cast<uint8_t>(1u << (nextFlip % 8));
+            count.flippedBits++;
+            nextFlip += 1 + gap(rng);
+        }
+        if (options.drop > 0 && drop(rng)) {
+            count.droppedBytes++;
+            continue;
+        }
+        out.push_back(byte);
+        if (options.dup > 0 && dup(rng)) {
+            out.push_back(byte);
+            count.duplicatedBytes++;
+        }
+    }
+    return out;
+}
+
+/*
+ * Split every pair of frames at every offset and check both frames are dispatched.
+ */
+template <class Config>
+void splitSweep() {
+    size_t passed = 0;
+    size_t total = 0;
+    std::mt19937 rng(7);
+    for (uint8_t id = 0; id < static_cast<uint8_t>(COMMAND_ID::Last); id++) {
+        SentFrames sent;
+        const std::vector<uint8_t> first = generate<Config>(1, rng, sent);
+        const std::vector<uint8_t> second = generate<Config>(1, rng, sent);
+        std::vector<uint8_t> pair = first;
+        pair.insert(pair.end(), second.begin(), second.end());
+        for (size_t offset = 1; offset < pair.size(); offset++) {
+            SentFrames expected = sent;
+            Link<Config> receiver(&expected);
+            receiver.manager.receive(pair.begin(), pair.begin() + offset);
+            receiver.manager.processReceiveAll();
+            receiver.manager.receive(pair.begin() + offset, pair.end());
+            receiver.manager.processReceiveAll();
+            total++;
+            passed += expected.recovered == 2 && expected.falseAccepts == 0;
+        }
+    }
+    std::printf("split sweep:      %zu/%zu splits recovered both frames\n", passed, total);
+}
+
+void printStatistics(const LinkStatistics &stats) {
+    static const char *const names[] = {"bytes in",     "ring overflow", "skipped bytes", "bad framing",
+                                        "bad checksum", "bad id",        "bad length",    "no handler"};
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(LinkCounter::Last), "names of LinkCounter");
+    std::printf("link statistics:");
+    for (size_t i = 0; i < stats.counters.size(); i++) {
+        std::printf(" %s=%u", names[i], stats.counters[i]);
+    }
+    std::printf("\n");
+}
+
+template <class Config>
+int run(const Options &options) {
+    std::mt19937 rng(options.seed);
+    SentFrames sent;
+    std::vector<uint8_t> stream;
+    Impairments impairments;
+    if (options.input.empty()) {
+        const std::vector<uint8_t> clean = generate<Config>(options.frames, rng, sent);
+        stream = impair(clean, options, rng, impairments);
+        std::printf("stream:           %zu frames, %zu bytes, %zu bytes after impairment\n", sent.size(), clean.size(),
+                    stream.size());
+        std::printf("impairments:      %zu bits flipped, %zu bytes dropped, %zu bytes duplicated\n",
+                    impairments.flippedBits, impairments.droppedBytes, impairments.duplicatedBytes);
+    } else {
+        std::ifstream file(options.input, std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "can not read %s\n", options.input.c_str());
+            return 1;
+        }
+        stream.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        std::printf("stream:           %zu bytes from %s\n", stream.size(), options.input.c_str());
+    }
+    if (!options.output.empty()) {
+        std::ofstream file(options.output, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(stream.data()), stream.size());
+    }
+
+    Link<Config> receiver(&sent);
+    std::uniform_int_distribution<size_t> chunkDist(options.chunkMin, options.chunkMax);
+    std::vector<size_t> chunks;
+    for (size_t pos = 0; pos < stream.size();) {
+        chunks.push_back(std::min(chunkDist(rng), stream.size() - pos));
+        pos += chunks.back();
+    }
+
+    size_t dispatched = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    size_t pos = 0;
+    for (size_t c = 0; c < chunks.size(); c++) {
+        receiver.manager.receive(stream.begin() + pos, stream.begin() + pos + chunks[c]);
+        pos += chunks[c];
+        if ((c + 1) % options.parseEvery == 0 || c + 1 == chunks.size()) {
+            dispatched += receiver.manager.processReceiveAll().frames;
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - begin).count();
+
+    std::printf("dispatched:       %zu frames\n", dispatched);
+    if (options.input.empty()) {
+        std::printf("recovery rate:    %.4f %% (%zu of %zu frames)\n", 100.0 * sent.recovered / sent.size(),
+                    sent.recovered, sent.size());
+        std::printf("false accepts:    %zu (%.3g per dispatched frame)\n", sent.falseAccepts,
+                    dispatched > 0 ? double(sent.falseAccepts) / dispatched : 0.0);
+    }
+    std::printf("throughput:       %.1f MB/s, %.2f ns/byte\n", stream.size() / seconds / 1e6,
+                seconds * 1e9 / std::max<size_t>(stream.size(), 1));
+    printStatistics(receiver.manager.statistics());
+    if (options.input.empty()) {
+        splitSweep<Config>();
+    }
+    return 0;
+}
+
+template <class IntegrityT, class FramingT, size_t Capacity>
+struct StressConfig : DefaultManagerConfig {
+    static constexpr size_t rxCapacity = Capacity;
+    using Integrity = IntegrityT;
+    using Framing = FramingT;
+};
+
+template <class IntegrityT, class FramingT>
+int selectCapacity(const Options &options) {
+    switch (options.rx) {
+    case 256:
+        return run<StressConfig<IntegrityT, FramingT, 256>>(options);
+    case 1024:
+        return run<StressConfig<IntegrityT, FramingT, 1024>>(options);
+    case 4096:
+        return run<StressConfig<IntegrityT, FramingT, 4096>>(options);
+    default:
+        std::fprintf(stderr, "rx must be 256, 1024 or 4096\n");
+        return 2;
+    }
+}
+
+template <class IntegrityT>
+int selectFraming(const Options &options) {
+    if (options.framing == "delimited") {
+        return selectCapacity<IntegrityT, framing::Delimited>(options);
+    }
+    if (options.framing == "cobs") {
+        return selectCapacity<IntegrityT, framing::Cobs>(options);
+    }
+    std::fprintf(stderr, "framing must be delimited or cobs\n");
+    return 2;
+}
+
+int select(const Options &options) {
+    std::printf("config:           framing=%s integrity=%s rx=%zu chunks=%zu..%zu parse-every=%zu\n",
+                options.framing.c_str(), options.integrity.c_str(), options.rx, options.chunkMin, options.chunkMax,
+                options.parseEvery);
+    if (options.integrity == "sum8") {
+        return selectFraming<integrity::Sum8>(options);
+    }
+    if (options.integrity == "crc8") {
+        return selectFraming<integrity::Crc8>(options);
+    }
+    if (options.integrity == "crc16") {
+        return selectFraming<integrity::Crc16Ccitt>(options);
+    }
+    if (options.integrity == "crc32c") {
+        return selectFraming<integrity::Crc32c>(options);
+    }
+    std::fprintf(stderr, "integrity must be sum8, crc8, crc16 or crc32c\n");
+    return 2;
+}
+
+bool parse(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const size_t eq = arg.find('=');
+        if (arg.compare(0, 2, "--") != 0 || eq == std::string::npos) {
+            return false;
+        }
+        const std::string name = arg.substr(2, eq - 2);
+        const std::string value = arg.substr(eq + 1);
+        if (name == "frames") {
+            options.frames = std::stoul(value);
+        } else if (name == "seed") {
+            options.seed = static_cast<uint32_t>(std::stoul(value));
+        } else if (name == "ber") {
+            options.ber = std::stod(value);
+        } else if (name == "drop") {
+            options.drop = std::stod(value);
+        } else if (name == "dup") {
+            options.dup = std::stod(value);
+        } else if (name == "chunk-min") {
+            options.chunkMin = std::stoul(value);
+        } else if (name == "chunk-max") {
+            options.chunkMax = std::stoul(value);
+        } else if (name == "parse-every") {
+            options.parseEvery = std::stoul(value);
+        } else if (name == "integrity") {
+            options.integrity = value;
+        } else if (name == "framing") {
+            options.framing = value;
+        } else if (name == "rx") {
+            options.rx = std::stoul(value);
+        } else if (name == "input") {
+            options.input = value;
+        } else if (name == "output") {
+            options.output = value;
+        } else {
+            return false;
+        }
+    }
+    return options.chunkMin > 0 && options.chunkMin <= options.chunkMax && options.parseEvery > 0 &&
+           options.ber >= 0 && options.ber < 1 && options.drop >= 0 && options.drop < 1 && options.dup >= 0 &&
+           options.dup < 1;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    try {
+        if (!parse(argc, argv, options)) {
+            std::fprintf(stderr, "usage: %s [--name=value]...  (see the top of LinkStress_bench.cpp)\n", argv[0]);
+            return 2;
+        }
+    } catch (const std::exception &) {
+        std::fprintf(stderr, "invalid option value\n");
+        return 2;
+    }
+    return select(options);
+}
@@ -0,0 +1,127 @@
+/*
+ * Loopback benchmark of SerialTransport: the vehicle end sends IMU frames as fast as the link takes them and the
+ * ground end receives and dispatches them. Reports the bytes/s and frames/s of both ends and the latency from the
+ * read() of a frame to the return of its dispatch.
+ *
+ * Build on the host, e.g.
+ *   g++ -std=c++17 -O2 -I. bench/PtyLoopback_bench.cpp *.cpp -o pty_loopback
+ *   ./pty_loopback --frames=200000
+ *   ./pty_loopback --device=/dev/ttyUSB0 --baud=921600 --frames=10000
+ *
+ * Options (--name=value):
+ *   frames   frames to send (100000)
+ *   device   a tty whose TX is wired to its RX; one transport then sends and receives. A pty pair by default
+ *   baud     rate of device (115200)
+ *   timeout  seconds to wait for the last frame (10)
+ */
+#include "../Inc/SerialTransport.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+using namespace command;
+
+namespace {
+
+struct Options {
+    size_t frames = 100000;
+    std::string device;
+    uint32_t baud = 115200;
+    int timeout = 10;
+};
+
+bool parse(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const size_t eq = arg.find('=');
+        if (arg.compare(0, 2, "--") != 0 || eq == std::string::npos) {
+            return false;
+        }
+        const std::string name = arg.substr(2, eq - 2);
+        const std::string value = arg.substr(eq + 1);
+        if (name == "frames") {
+            options.frames = std::stoul(value);
+        } else if (name == "device") {
+            options.device = value;
+        } else if (name == "baud") {
+            options.baud = static_cast<uint32_t>(std::stoul(value));
+        } else if (name == "timeout") {
+            options.timeout = std::stoi(value);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// One end of the link: its manager sends and receives IMU frames.
+struct Station {
+    CommandManager manager;
+    Imu imu;
+    size_t received = 0;
+
+    Station() {
+        imu.setCallback([this](CommandDataType::IMU &) { received++; });
+        manager[COMMAND_ID::IMU] = &imu;
+    }
+};
+
+void report(const char *name, const TransportStatistics &stats) {
+    std::printf("%-8s write %10.0f B/s (%llu writes)  read %10.0f B/s (%llu reads)\n", name, stats.writeRate(),
+                static_cast<unsigned long long>(stats.writes), stats.readRate(), static_cast<unsigned long long>(stats.reads));
+    if (stats.framesReceived > 0) {
+        const double seconds = stats.elapsedNs / 1e9;
+        std::printf("%-8s %llu frames  %.0f frames/s  read to dispatch mean %.0f ns max %llu ns\n", name,
+                    static_cast<unsigned long long>(stats.framesReceived), stats.framesReceived / seconds,
+                    stats.meanLatencyNs(), static_cast<unsigned long long>(stats.latencyMaxNs));
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        std::fprintf(stderr, "usage: %s [--frames=N] [--device=PATH] [--baud=N] [--timeout=S]\n", argv[0]);
+        return 2;
+    }
+
+    SerialPort ground;
+    SerialPort vehicle;
+    const bool opened = options.device.empty() ? ground.openPty(vehicle) : ground.open(options.device.c_str(), options.baud);
+    if (!opened) {
+        std::fprintf(stderr, "can not open %s\n", options.device.empty() ? "a pty" : options.device.c_str());
+        return 1;
+    }
+
+    Station groundStation;
+    Station vehicleStation;
+    SerialTransport<> groundLink(groundStation.manager, ground.fd());
+    // on a wired loopback the ground end receives its own frames
+    SerialTransport<> vehicleLink(vehicleStation.manager, vehicle.isOpen() ? vehicle.fd() : -1);
+    SerialTransport<> &sender = vehicle.isOpen() ? vehicleLink : groundLink;
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(options.timeout);
+    size_t sent = 0;
+    while (groundStation.received < options.frames && std::chrono::steady_clock::now() < deadline) {
+        while (sent < options.frames && sender.send(COMMAND_ID::IMU)) {
+            sent++;
+        }
+        if (&sender != &groundLink) {
+            sender.poll(0);
+        }
+        groundLink.poll(1);
+        if (!groundLink.isOpen() || !sender.isOpen()) {
+            break;
+        }
+    }
+
+    std::printf("frames   %zu sent, %zu received, %zu bytes each\n", sent, groundStation.received,
+                static_cast<size_t>(CommandManager::getFrameLen(COMMAND_ID::IMU)));
+    if (&sender != &groundLink) {
+        report("vehicle", vehicleLink.statistics());
+    }
+    report("ground", groundLink.statistics());
+    return groundStation.received == options.frames ? 0 : 1;
+}
@@ -1,6 +1,7 @@
 #include "../Inc/CommandHandlers.hpp"
 
 #include <array>
+#include <cmath>
 #include <cstring>
 #include <iostream>
 #include <stdexcept>
@@ -188,8 +189,82 @@ void testSensorStatusTransmit() {
     if (payload.size() != 1) {
         throw std::runtime_error("SensorStatus payload length mismatch");
     }
-    if (payload[0] != 0) {
-        throw std::runtime_error("SensorStatus expected zero encoding");
+    if (payload[0] != 0b00111111) {
+        throw std::runtime_error("SensorStatus flag encoding mismatch");
+    }
+
+    CommandDataType::SensorStatus partial;
+    partial.camera() = true;
+    partial.gps() = true;
+    SensorStatus partialHandler(partial);
+    if (partialHandler.transmit()[0] != 0b00010001) {
+        throw std::runtime_error("SensorStatus partial flag encoding mismatch");
+    }
+}
+
+void testConnectionCheckRoundTrip() {
+    ConnectionCheck sender([](uint8_t &, bool &) {});
+    sender.setData(0x15);
+    std::vector<uint8_t> payload = sender.transmit();
+    if (payload.size() != 1 || payload[0] != 0x15) {
+        throw std::runtime_error("ConnectionCheck encoding mismatch");
+    }
+
+    payload[0] = 0x80 | 0x7E;
+    ConnectionCheck receiver;
+    if (receiver.onReceive(payload) != COMMAND_ID::ConnectionCheck) {
+        throw std::runtime_error("ConnectionCheck should answer with ConnectionCheck");
+    }
+    if (receiver.getData() != 0x7E) {
+        throw std::runtime_error("ConnectionCheck data decode mismatch");
+    }
+    if (receiver.transmit()[0] != (0x80 | 0x7E)) {
+        throw std::runtime_error("ConnectionCheck loopback flag lost");
+    }
+}
+
+void testRelativeNavigationRoundTrip() {
+    CommandDataType::RelativeNavigation nav;
+    nav.relativePositionNorth() = -0x00045678;
+    nav.relativePositionEast() = 0x0000FEDC;
+    nav.headingDirection() = 45;
+    nav.leftMotorPower() = -10;
+    nav.rightMotorPower() = 10;
+    nav.isDetectedGoalOnCamera() = false;
+    nav.isDetectedGoalOnTof() = true;
+    nav.tofDistance() = 0x1ABC;
+    nav.goalDirection() = -90;
+
+    RelativeNavigation sender(nav);
+    auto payload = sender.transmit();
+    RelativeNavigation receiver;
+    receiver.onReceive(payload);
+    const auto &decoded = receiver.getData();
+    if (decoded.relativePositionNorth() != nav.relativePositionNorth() ||
+        decoded.relativePositionEast() != nav.relativePositionEast() ||
+        decoded.headingDirection() != nav.headingDirection() ||
+        decoded.leftMotorPower() != nav.leftMotorPower() ||
+        decoded.rightMotorPower() != nav.rightMotorPower() ||
+        decoded.isDetectedGoalOnCamera() != nav.isDetectedGoalOnCamera() ||
+        decoded.isDetectedGoalOnTof() != nav.isDetectedGoalOnTof() ||
+        decoded.tofDistance() != nav.tofDistance() ||
+        decoded.goalDirection() != nav.goalDirection()) {
+        throw std::runtime_error("RelativeNavigation round trip mismatch");
+    }
+}
+
+void testAbsoluteNavigationDecodeSignExtension() {
+    CommandDataType::AbsoluteNavigation nav;
+    nav.relativePositionNorth() = -0x00012345;
+    nav.relativePositionEast() = 0x00112233;
+
+    AbsoluteNavigation sender(nav);
+    auto payload = sender.transmit();
+    AbsoluteNavigation receiver;
+    receiver.onReceive(payload);
+    if (receiver.getData().relativePositionNorth() != (-0x00012345 >> 8) ||
+        receiver.getData().relativePositionEast() != (0x00112233 >> 8)) {
+        throw std::runtime_error("AbsoluteNavigation 24-bit decode mismatch");
     }
 }
 
@@ -223,6 +298,126 @@ void testServoConfigTransmit() {
     expectBytes(payload.data() + offset, close.data(), close.size(), "ServoConfig close count mismatch");
 }
 
+struct AltitudeSink {
+    int16_t last = 0;
+    void onAltitude(CommandDataType::Altitude &altitude) { last = altitude.altitude(); }
+};
+
+void testCallbackBinding() {
+    static_assert(sizeof(Callback<void(CommandDataType::Altitude &)>) <= 3 * sizeof(void *),
+                  "Callback should be three pointers at most");
+
+    CommandDataType::Altitude value;
+    value.altitude() = -42;
+    Altitude sender(value);
+    auto payload = sender.transmit();
+
+    AltitudeSink sink;
+    Altitude receiver;
+    receiver.setCallback(Callback<void(CommandDataType::Altitude &)>::bind<&AltitudeSink::onAltitude>(sink));
+    receiver.onReceive(payload);
+    if (sink.last != -42) {
+        throw std::runtime_error("Member function callback was not called");
+    }
+
+    int calls = 0;
+    int16_t last = 0;
+    receiver.setCallback([&calls, &last](CommandDataType::Altitude &altitude) {
+        calls++;
+        last = altitude.altitude();
+    });
+    receiver.onReceive(payload);
+    if (calls != 1 || last != -42) {
+        throw std::runtime_error("Lambda callback was not called");
+    }
+}
+
+void expectNear(float actual, float expected, float tolerance, const char *message) {
+    if (!(std::fabs(actual - expected) <= tolerance)) {
+        throw std::runtime_error(message);
+    }
+}
+
+void testImuCompactRoundTrip() {
+    CommandDataType::IMU imu;
+    imu.accel() = {1.0f, -9.81f, 15.99f};
+    imu.gyro() = {0.0f, 1999.0f, -250.5f};
+    imu.magnet() = {45.0f, -4900.0f, 12.3f};
+
+    ImuCompact sender;
+    sender.setData(imu);
+    const auto payload = sender.transmit();
+    if (payload.size() != 18) {
+        throw std::runtime_error("ImuCompact payload length mismatch");
+    }
+
+    CommandDataType::IMU received;
+    ImuCompact receiver;
+    receiver.setCallback([&](CommandDataType::IMU &value) { received = value; });
+    receiver.onReceive(FrameView(payload.data(), payload.size()));
+
+    const wire::ImuFullScale scale;
+    for (size_t i = 0; i < 3; i++) {
+#if COMMAND_IMU_COMPACT_HALF
+        // Half floats keep 11 significant bits.
+        expectNear(received.accel()[i], imu.accel()[i], std::fabs(imu.accel()[i]) / 1024, "ImuCompact accel out of tolerance");
+        expectNear(received.gyro()[i], imu.gyro()[i], std::fabs(imu.gyro()[i]) / 1024, "ImuCompact gyro out of tolerance");
+        expectNear(received.magnet()[i], imu.magnet()[i], std::fabs(imu.magnet()[i]) / 1024, "ImuCompact magnet out of tolerance");
+#else
+        // Scaled int16 is accurate to half a step of the full-scale range.
+        expectNear(received.accel()[i], imu.accel()[i], scale.accel / 32767 / 2 * 1.01f, "ImuCompact accel out of tolerance");
+        expectNear(received.gyro()[i], imu.gyro()[i], scale.gyro / 32767 / 2 * 1.01f, "ImuCompact gyro out of tolerance");
+        expectNear(received.magnet()[i], imu.magnet()[i], scale.magnet / 32767 / 2 * 1.01f, "ImuCompact magnet out of tolerance");
+#endif
+    }
+}
+
+void testScaledInt16Saturates() {
+    std::array<float, 3> value = {100.0f, -100.0f, std::nanf("")};
+    const float fullScale = 16.0f;
+    std::array<uint8_t, 6> out{};
+    wire::ScaledInt16<3>::encode(out.data(), std::tie(value, fullScale));
+
+    std::array<float, 3> decoded{};
+    wire::ScaledInt16<3>::decode(FrameView(out.data(), out.size()), 0, std::tie(decoded, fullScale));
+    if (decoded[0] != 16.0f || decoded[1] != -16.0f || decoded[2] != 0.0f) {
+        throw std::runtime_error("ScaledInt16 did not saturate");
+    }
+}
+
+void testHalfConversion() {
+    // Exactly representable values, the largest normal, the smallest subnormal and a tie rounding to even.
+    const std::array<float, 8> value = {0.0f, -1.5f, 0.25f, 65504.0f, 5.9604644775390625e-08f,
+                                        1.00048828125f, 1.00146484375f, -70000.0f};
+    const std::array<uint16_t, 8> expected = {0x0000, 0xbe00, 0x3400, 0x7bff, 0x0001, 0x3c00, 0x3c02, 0xfc00};
+    std::array<uint8_t, 16> out{};
+    wire::Half<8>::encode(out.data(), value);
+    for (size_t i = 0; i < value.size(); i++) {
+        if ((out[2 * i] | (out[2 * i + 1] << 8)) != expected[i]) {
+            throw std::runtime_error("Half encoding mismatch");
+        }
+    }
+
+    std::array<float, 8> decoded{};
+    wire::Half<8>::decode(FrameView(out.data(), out.size()), 0, decoded);
+    const std::array<float, 8> roundTrip = {0.0f, -1.5f, 0.25f, 65504.0f, 5.9604644775390625e-08f,
+                                            1.0f, 1.001953125f, -INFINITY};
+    if (decoded != roundTrip) {
+        throw std::runtime_error("Half decoding mismatch");
+    }
+
+    // Every half value other than NaN survives the software conversion both ways.
+    for (uint32_t raw = 0; raw < 0x10000; raw++) {
+        const float f = wire::detail::halfToFloat(static_cast<uint16_t>(raw));
+        if (std::isnan(f)) {
+            continue;
+        }
+        if (wire::detail::floatToHalf(f) != raw) {
+            throw std::runtime_error("Half software conversion does not round trip");
+        }
+    }
+}
+
 using TestFunc = void (*)();
 
 const std::vector<std::pair<const char *, TestFunc>> tests = {
@@ -232,7 +427,14 @@ const std::vector<std::pair<const char *, TestFunc>> tests = {
     {"Absolute navigation transmit", testAbsoluteNavigationTransmit},
     {"Relative navigation transmit", testRelativeNavigationTransmit},
     {"Sensor status transmit", testSensorStatusTransmit},
-    {"Servo config transmit", testServoConfigTransmit}
+    {"Servo config transmit", testServoConfigTransmit},
+    {"Connection check round trip", testConnectionCheckRoundTrip},
+    {"Relative navigation round trip", testRelativeNavigationRoundTrip},
+    {"Absolute navigation decode sign extension", testAbsoluteNavigationDecodeSignExtension},
+    {"Callback binding", testCallbackBinding},
+    {"ImuCompact round trip", testImuCompactRoundTrip},
+    {"ScaledInt16 saturates", testScaledInt16Saturates},
+    {"Half conversion", testHalfConversion}
 };
 
 } // namespace
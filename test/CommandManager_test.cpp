@@ -0,0 +1,724 @@
+#include "../Inc/CommandManager.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "TestSupport.hpp"
+
+using namespace command;
+using namespace testsupport;
+
+namespace {
+
+template <typename T>
+std::vector<uint8_t> toBytes(const T &value) {
+    std::vector<uint8_t> out(sizeof(T));
+    std::memcpy(out.data(), &value, sizeof(T));
+    return out;
+}
+
+class LegacyHandler : public Base {
+public:
+    std::vector<uint8_t> lastBody;
+    COMMAND_ID onReceive(std::vector<uint8_t> &body) override {
+        lastBody = body;
+        return COMMAND_ID::Last;
+    }
+};
+
+void testProcessReceiveContiguous() {
+    CommandManager manager;
+    Mode mode;
+    uint8_t received = 0;
+    mode.setCallback([&](uint8_t value) { received = value; });
+    manager[COMMAND_ID::Mode] = &mode;
+
+    const auto frame = makeFrame(COMMAND_ID::Mode, {0x42});
+    manager.receive(frame.begin(), frame.end());
+    if (manager.processReceive() != COMMAND_ID::Mode) {
+        throw std::runtime_error("Mode frame was not dispatched");
+    }
+    if (received != 0x42) {
+        throw std::runtime_error("Mode value mismatch");
+    }
+}
+
+void testProcessReceiveWrappedWithoutAllocation() {
+    CommandManager manager;
+    Goal goal;
+    CommandDataType::Coordinates received;
+    goal.setCallback([&](CommandDataType::Coordinates &value) { received = value; });
+    manager[COMMAND_ID::Goal] = &goal;
+
+    // Move the cursors close to the end of the ring so the next frame wraps around.
+    const std::vector<uint8_t> noise(120, 'x');
+    manager.receive(noise.begin(), noise.end());
+    manager.processReceive();
+
+    std::vector<uint8_t> body = toBytes(35.689487);
+    const auto lon = toBytes(139.691711);
+    body.insert(body.end(), lon.begin(), lon.end());
+    const auto frame = makeFrame(COMMAND_ID::Goal, body);
+    manager.receive(frame.begin(), frame.end());
+
+    const size_t before = allocationCount;
+    const COMMAND_ID id = manager.processReceive();
+    if (allocationCount != before) {
+        throw std::runtime_error("processReceive allocated");
+    }
+    if (id != COMMAND_ID::Goal) {
+        throw std::runtime_error("Wrapped Goal frame was not dispatched");
+    }
+    if (received.latitude() != 35.689487 || received.longitude() != 139.691711) {
+        throw std::runtime_error("Wrapped Goal decode mismatch");
+    }
+}
+
+void testLegacyVectorHandler() {
+    CommandManager manager;
+    LegacyHandler handler;
+    manager[COMMAND_ID::Mode] = &handler;
+
+    const auto frame = makeFrame(COMMAND_ID::Mode, {0x07});
+    if (manager.onReceiveFrame(frame.data(), frame.data() + frame.size()) != COMMAND_ID::Mode) {
+        throw std::runtime_error("Legacy handler frame was not dispatched");
+    }
+    if (handler.lastBody != std::vector<uint8_t>{0x07}) {
+        throw std::runtime_error("Legacy handler body mismatch");
+    }
+}
+
+void testRejectBadChecksum() {
+    CommandManager manager;
+    Mode mode;
+    manager[COMMAND_ID::Mode] = &mode;
+
+    auto frame = makeFrame(COMMAND_ID::Mode, {0x01});
+    frame[3]++;
+    if (manager.onReceiveFrame(frame.data(), frame.data() + frame.size()) != COMMAND_ID::Last) {
+        throw std::runtime_error("Frame with bad checksum was accepted");
+    }
+}
+
+void testProcessReceiveAllDrainsBurst() {
+    CommandManager manager;
+    Mode mode;
+    Altitude altitude;
+    ConnectionCheck check;
+    manager[COMMAND_ID::Mode] = &mode;
+    manager[COMMAND_ID::Altitude] = &altitude;
+    manager[COMMAND_ID::ConnectionCheck] = &check;
+
+    std::vector<uint8_t> burst = {'x', 'y'};
+    for (const auto &frame : {makeFrame(COMMAND_ID::Mode, {0x01}),
+                              makeFrame(COMMAND_ID::Altitude, std::vector<uint8_t>(10, 0x11)),
+                              makeFrame(COMMAND_ID::ConnectionCheck, {0x05})}) {
+        burst.insert(burst.end(), frame.begin(), frame.end());
+        burst.push_back('z');
+    }
+    manager.receive(burst.begin(), burst.end());
+
+    const ReceiveSummary summary = manager.processReceiveAll();
+    if (summary.frames != 3) {
+        throw std::runtime_error("Drain frame count mismatch");
+    }
+    if (!summary.seen(COMMAND_ID::Mode) || !summary.seen(COMMAND_ID::Altitude) ||
+        !summary.seen(COMMAND_ID::ConnectionCheck) || summary.seen(COMMAND_ID::GPS)) {
+        throw std::runtime_error("Drain id set mismatch");
+    }
+    if (summary.skippedBytes != 4) {
+        throw std::runtime_error("Drain skipped byte count mismatch");
+    }
+}
+
+void testProcessReceiveAllFrameBudget() {
+    CommandManager manager;
+    Mode mode;
+    manager[COMMAND_ID::Mode] = &mode;
+
+    std::vector<uint8_t> burst;
+    for (uint8_t i = 0; i < 3; i++) {
+        const auto frame = makeFrame(COMMAND_ID::Mode, {i});
+        burst.insert(burst.end(), frame.begin(), frame.end());
+    }
+    manager.receive(burst.begin(), burst.end());
+
+    if (manager.processReceiveAll(2).frames != 2) {
+        throw std::runtime_error("Frame budget was not respected");
+    }
+    if (manager.processReceiveAll().frames != 1) {
+        throw std::runtime_error("Remaining frame was lost");
+    }
+}
+
+void testResyncAcrossNoiseAndWrap() {
+    CommandManager manager;
+    Mode mode;
+    std::vector<uint8_t> received;
+    mode.setCallback([&](uint8_t value) { received.push_back(value); });
+    manager[COMMAND_ID::Mode] = &mode;
+
+    // Noise with false start bytes, fed in small chunks so frames cross the end of the ring.
+    std::vector<uint8_t> stream;
+    for (uint8_t i = 0; i < 40; i++) {
+        const std::vector<uint8_t> noise = {'s', 0xff, 'x', 's', 0x05, 'q', 'e', 0x00, 's'};
+        stream.insert(stream.end(), noise.begin(), noise.begin() + (i % noise.size()));
+        const auto frame = makeFrame(COMMAND_ID::Mode, {i});
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+    for (size_t offset = 0; offset < stream.size(); offset += 7) {
+        const size_t len = std::min<size_t>(7, stream.size() - offset);
+        manager.receive(stream.begin() + offset, stream.begin() + offset + len);
+        manager.processReceiveAll();
+    }
+
+    if (received.size() != 40) {
+        throw std::runtime_error("Frames were lost while resynchronizing");
+    }
+    for (uint8_t i = 0; i < 40; i++) {
+        if (received[i] != i) {
+            throw std::runtime_error("Frame order mismatch after resynchronizing");
+        }
+    }
+}
+
+void testTransmitFrameToBufferWithoutAllocation() {
+    CommandManager manager;
+    CommandDataType::Altitude value;
+    value.altitude() = 321;
+    value.pressure() = 1000.5f;
+    value.temperature() = -3.25f;
+    Altitude altitude(value);
+    manager[COMMAND_ID::Altitude] = &altitude;
+
+    std::array<uint8_t, CommandManager::MAX_FRAME_LEN> buffer{};
+    const size_t before = allocationCount;
+    const size_t length = manager.constructTransmitFrameInto(COMMAND_ID::Altitude, buffer.data(), buffer.size());
+    if (allocationCount != before) {
+        throw std::runtime_error("constructTransmitFrameInto allocated");
+    }
+
+    const auto frame = manager.constructTransmitFrame(COMMAND_ID::Altitude);
+    if (length != 14 || frame.size() != length || !std::equal(frame.begin(), frame.end(), buffer.begin())) {
+        throw std::runtime_error("Buffer frame does not match vector frame");
+    }
+    uint8_t capacity = 13;
+    if (manager.constructTransmitFrameInto(COMMAND_ID::Altitude, buffer.data(), capacity) != 0 || capacity != 13) {
+        throw std::runtime_error("Frame larger than the buffer was written");
+    }
+    uint8_t legacyLength = 0;
+    manager.constructTransmitFrameToBuffer(COMMAND_ID::Altitude, buffer.data(), legacyLength);
+    if (legacyLength != length) {
+        throw std::runtime_error("Legacy form length mismatch");
+    }
+
+    CommandManager receiver;
+    Altitude decoded;
+    receiver[COMMAND_ID::Altitude] = &decoded;
+    if (receiver.onReceiveFrame(buffer.data(), buffer.data() + length) != COMMAND_ID::Altitude) {
+        throw std::runtime_error("Serialized frame was rejected");
+    }
+    if (decoded.getData().altitude() != 321 || decoded.getData().temperature() != -3.25f) {
+        throw std::runtime_error("Serialized frame decode mismatch");
+    }
+}
+
+void testReceiveRingConcurrentProducer() {
+    ReceiveRing<64> ring;
+    constexpr uint32_t total = 200000;
+
+    std::thread producer([&ring]() {
+        uint32_t next = 0;
+        while (next < total) {
+            std::array<uint8_t, 7> chunk;
+            for (size_t i = 0; i < chunk.size(); i++) {
+                chunk[i] = static_cast<uint8_t>(next + i);
+            }
+            const size_t len = std::min<size_t>(chunk.size(), total - next);
+            next += ring.push(chunk.begin(), chunk.begin() + len);
+        }
+    });
+
+    uint32_t expected = 0;
+    bool ordered = true;
+    while (expected < total) {
+        const size_t readable = ring.readable();
+        for (size_t i = 0; i < readable; i++) {
+            ordered = ordered && ring.peek(i) == static_cast<uint8_t>(expected + i);
+        }
+        ring.consume(readable);
+        expected += readable;
+    }
+    producer.join();
+
+    if (!ordered) {
+        throw std::runtime_error("Bytes were torn or reordered between producer and consumer");
+    }
+}
+
+void testReceiveDropsBytesWhenFull() {
+    CommandManager manager;
+    Mode mode;
+    manager[COMMAND_ID::Mode] = &mode;
+
+    const std::vector<uint8_t> noise(DefaultManagerConfig::rxCapacity - 2, 'x');
+    manager.receive(noise.begin(), noise.end());
+    const auto frame = makeFrame(COMMAND_ID::Mode, {0x01});
+    manager.receive(frame.begin(), frame.end());
+    manager.processReceiveAll();
+
+    // The truncated frame must not have corrupted the unread data; the ring keeps working.
+    manager.receive(frame.begin(), frame.end());
+    if (manager.processReceiveAll().frames != 1) {
+        throw std::runtime_error("Frame after overflow was not dispatched");
+    }
+}
+
+struct LargeRingConfig : DefaultManagerConfig {
+    static constexpr size_t rxCapacity = 4096;
+};
+
+void testLargeRingTakesUsbSizedChunk() {
+    BasicCommandManager<LargeRingConfig> manager;
+    Mode mode;
+    manager[COMMAND_ID::Mode] = &mode;
+
+    std::vector<uint8_t> chunk;
+    while (chunk.size() + 5 <= 4096) {
+        const auto frame = makeFrame(COMMAND_ID::Mode, {static_cast<uint8_t>(chunk.size())});
+        chunk.insert(chunk.end(), frame.begin(), frame.end());
+    }
+    manager.receive(chunk.begin(), chunk.end());
+    if (manager.processReceiveAll().frames != chunk.size() / 5) {
+        throw std::runtime_error("Frames of a large chunk were lost");
+    }
+}
+
+struct CobsConfig : DefaultManagerConfig {
+    using Framing = framing::Cobs;
+};
+
+void testCobsEncoding() {
+    BasicCommandManager<CobsConfig> manager;
+    Mode mode;
+    manager[COMMAND_ID::Mode] = &mode;
+
+    // Raw frame {ID, body, sum} = {0x05, 0x00, 0x05}.
+    std::array<uint8_t, BasicCommandManager<CobsConfig>::MAX_FRAME_LEN> buffer;
+    const size_t len = manager.constructTransmitFrameInto(COMMAND_ID::Mode, buffer.data(), buffer.size());
+    const std::vector<uint8_t> expected = {0x02, 0x05, 0x02, 0x05, 0x00};
+    if (len != expected.size() || !std::equal(expected.begin(), expected.end(), buffer.begin())) {
+        throw std::runtime_error("COBS encoding mismatch");
+    }
+}
+
+void testCobsRoundTripWithZeroes() {
+    BasicCommandManager<CobsConfig> manager;
+    Goal goal;
+    CommandDataType::Coordinates value;
+    value.latitude() = 0.0;
+    value.longitude() = 139.25;
+    goal.setData(value);
+    CommandDataType::Coordinates received;
+    goal.setCallback([&](CommandDataType::Coordinates &data) { received = data; });
+    manager[COMMAND_ID::Goal] = &goal;
+
+    const std::vector<uint8_t> frame = manager.constructTransmitFrame(COMMAND_ID::Goal);
+    if (frame.size() != manager.getFrameLen(COMMAND_ID::Goal) || frame.back() != 0x00 ||
+        std::find(frame.begin(), frame.end() - 1, 0x00) != frame.end() - 1) {
+        throw std::runtime_error("COBS frame contains a zero before the delimiter");
+    }
+
+    // Wrap the frame around the end of the ring.
+    const std::vector<uint8_t> noise(CobsConfig::rxCapacity - 5, 'x');
+    manager.receive(noise.begin(), noise.end());
+    manager.processReceiveAll();
+    manager.receive(frame.begin(), frame.end());
+    if (manager.processReceive() != COMMAND_ID::Goal) {
+        throw std::runtime_error("COBS frame was not dispatched");
+    }
+    if (received.latitude() != 0.0 || received.longitude() != 139.25) {
+        throw std::runtime_error("COBS payload mismatch");
+    }
+}
+
+void testCobsResyncAfterCorruption() {
+    BasicCommandManager<CobsConfig> manager;
+    Mode mode;
+    std::vector<uint8_t> received;
+    mode.setCallback([&](uint8_t value) { received.push_back(value); });
+    manager[COMMAND_ID::Mode] = &mode;
+
+    std::array<uint8_t, BasicCommandManager<CobsConfig>::MAX_FRAME_LEN> buffer;
+    std::vector<uint8_t> stream;
+    for (uint8_t i = 0; i < 40; i++) {
+        // A damaged frame and noise holding start and stop bytes, each ended by a delimiter.
+        mode.setData(static_cast<uint8_t>(i + 100));
+        size_t len = manager.constructTransmitFrameInto(COMMAND_ID::Mode, buffer.data(), buffer.size());
+        buffer[1] ^= 0x40;
+        stream.insert(stream.end(), buffer.begin() + (i % 2), buffer.begin() + len);
+        const std::vector<uint8_t> noise = {'s', 0x05, 's', 'e', 0xff, 'e', 0x00};
+        stream.insert(stream.end(), noise.begin(), noise.begin() + (i % noise.size()));
+        stream.push_back(0x00);
+
+        mode.setData(i);
+        len = manager.constructTransmitFrameInto(COMMAND_ID::Mode, buffer.data(), buffer.size());
+        stream.insert(stream.end(), buffer.begin(), buffer.begin() + len);
+    }
+    for (size_t offset = 0; offset < stream.size(); offset += 7) {
+        const size_t len = std::min<size_t>(7, stream.size() - offset);
+        manager.receive(stream.begin() + offset, stream.begin() + offset + len);
+        manager.processReceiveAll();
+    }
+
+    if (received.size() != 40) {
+        throw std::runtime_error("COBS frames were lost while resynchronizing");
+    }
+    for (uint8_t i = 0; i < 40; i++) {
+        if (received[i] != i) {
+            throw std::runtime_error("COBS frame order mismatch after resynchronizing");
+        }
+    }
+}
+
+struct SuperframeConfig : DefaultManagerConfig {
+    static constexpr size_t superframeMtu = 64;
+};
+
+struct CobsSuperframeConfig : SuperframeConfig {
+    using Framing = framing::Cobs;
+};
+
+template <typename Config>
+void superframeRoundTrip() {
+    using Manager = BasicCommandManager<Config>;
+    Manager manager;
+    Imu imu;
+    Altitude altitude;
+    Gps gps;
+    AbsoluteNavigation navigation;
+    manager[COMMAND_ID::IMU] = &imu;
+    manager[COMMAND_ID::Altitude] = &altitude;
+    manager[COMMAND_ID::GPS] = &gps;
+    manager[COMMAND_ID::AbsoluteNavigationLog] = &navigation;
+
+    CommandDataType::Altitude sent;
+    sent.altitude() = 120;
+    sent.pressure() = 1001.5f;
+    sent.temperature() = 21.25f;
+    altitude.setData(sent);
+    CommandDataType::Altitude received;
+    altitude.setCallback([&](CommandDataType::Altitude &value) { received = value; });
+
+    // IMU and Altitude fill 53 of 64 bytes, so GPS and AbsoluteNavigation go into a second superframe.
+    const std::array<COMMAND_ID, 4> ids = {COMMAND_ID::IMU, COMMAND_ID::Altitude, COMMAND_ID::GPS,
+                                           COMMAND_ID::AbsoluteNavigationLog};
+    std::array<uint8_t, 128> buffer;
+    std::vector<uint8_t> stream;
+    size_t packed = 0;
+    size_t len = manager.constructSuperframeToBuffer(ids.data(), ids.size(), buffer.data(), buffer.size(), packed);
+    if (packed != 2 || len != 53 || len > Config::superframeMtu) {
+        throw std::runtime_error("First superframe packing mismatch");
+    }
+    stream.insert(stream.end(), buffer.begin(), buffer.begin() + len);
+    len = manager.constructSuperframeToBuffer(ids.data() + 2, ids.size() - 2, buffer.data(), buffer.size(), packed);
+    if (packed != 2 || len != 34) {
+        throw std::runtime_error("Second superframe packing mismatch");
+    }
+    stream.insert(stream.end(), buffer.begin(), buffer.begin() + len);
+
+    manager.receive(stream.begin(), stream.end());
+    const ReceiveSummary summary = manager.processReceiveAll();
+    if (summary.frames != 4 || !summary.seen(COMMAND_ID::IMU) || !summary.seen(COMMAND_ID::Altitude) ||
+        !summary.seen(COMMAND_ID::GPS) || !summary.seen(COMMAND_ID::AbsoluteNavigationLog)) {
+        throw std::runtime_error("Superframe entries were not dispatched");
+    }
+    if (received.altitude() != 120 || received.pressure() != 1001.5f || received.temperature() != 21.25f) {
+        throw std::runtime_error("Superframe payload mismatch");
+    }
+}
+
+void testSuperframeRoundTrip() {
+    superframeRoundTrip<SuperframeConfig>();
+    superframeRoundTrip<CobsSuperframeConfig>();
+}
+
+void testSuperframeRejectsBadEntry() {
+    BasicCommandManager<SuperframeConfig> manager;
+    Mode mode;
+    int calls = 0;
+    mode.setCallback([&](uint8_t) { calls++; });
+    manager[COMMAND_ID::Mode] = &mode;
+
+    // Two Mode entries followed by an unknown ID; nothing may be dispatched.
+    const std::vector<uint8_t> payload = {0xff, 6, 0x05, 0x01, 0x05, 0x02, 0x7f, 0x00};
+    std::vector<uint8_t> frame = {'s'};
+    uint8_t sum = 0;
+    for (auto b : payload) {
+        frame.push_back(b);
+        sum += b;
+    }
+    frame.push_back(sum);
+    frame.push_back('e');
+    if (manager.onReceiveFrame(frame.data(), frame.data() + frame.size()) != COMMAND_ID::Last || calls != 0) {
+        throw std::runtime_error("Superframe with a bad entry was dispatched");
+    }
+
+    // Without superframeMtu the marker is an unknown ID.
+    CommandManager plain;
+    plain[COMMAND_ID::Mode] = &mode;
+    const std::array<COMMAND_ID, 1> ids = {COMMAND_ID::Mode};
+    std::array<uint8_t, 64> buffer;
+    size_t packed = 0;
+    if (plain.constructSuperframeToBuffer(ids.data(), ids.size(), buffer.data(), buffer.size(), packed) != 0) {
+        throw std::runtime_error("Superframe was built with superframes disabled");
+    }
+}
+
+struct DmaConfig : DefaultManagerConfig {
+    template <size_t Size>
+    using Ring = DmaReceiveRing<Size>;
+};
+
+/*
+ * Circular DMA: writes bytes into the ring memory and reports the position like the half/full interrupts.
+ */
+struct FakeCircularDma {
+    DmaReceiveRing<DmaConfig::rxCapacity> &ring;
+    size_t position = 0;
+
+    void write(const std::vector<uint8_t> &bytes) {
+        for (size_t i = 0; i < bytes.size(); i++) {
+            ring.data()[position] = bytes[i];
+            position = (position + 1) % ring.capacity();
+            if (position % (ring.capacity() / 2) == 0) {
+                ring.update(position);
+            }
+        }
+        ring.update(position); // idle line
+    }
+};
+
+void testDmaRingParsesInPlace() {
+    BasicCommandManager<DmaConfig> manager;
+    Mode mode;
+    std::vector<uint8_t> received;
+    mode.setCallback([&](uint8_t value) { received.push_back(value); });
+    manager[COMMAND_ID::Mode] = &mode;
+    FakeCircularDma dma{manager.receiveRing()};
+    received.reserve(80);
+
+    // 5-byte frames in 128 bytes: frames cross the edge of the DMA buffer.
+    for (uint8_t i = 0; i < 80; i++) {
+        dma.write(makeFrame(COMMAND_ID::Mode, {i}));
+        if (i % 3 == 2) {
+            const size_t before = allocationCount;
+            manager.processReceiveAll();
+            if (allocationCount != before) {
+                throw std::runtime_error("Parsing from the DMA ring allocated");
+            }
+        }
+    }
+    manager.processReceiveAll();
+
+    if (received.size() != 80 || manager.receiveRing().overruns() != 0) {
+        throw std::runtime_error("Frames were lost in the DMA ring");
+    }
+    for (uint8_t i = 0; i < 80; i++) {
+        if (received[i] != i) {
+            throw std::runtime_error("DMA ring frame order mismatch");
+        }
+    }
+}
+
+void testDmaRingDetectsLap() {
+    BasicCommandManager<DmaConfig> manager;
+    Mode mode;
+    std::vector<uint8_t> received;
+    mode.setCallback([&](uint8_t value) { received.push_back(value); });
+    manager[COMMAND_ID::Mode] = &mode;
+    FakeCircularDma dma{manager.receiveRing()};
+
+    // 26 frames (130 bytes) without parsing: the DMA overwrote the oldest ones.
+    for (uint8_t i = 0; i < 26; i++) {
+        dma.write(makeFrame(COMMAND_ID::Mode, {i}));
+    }
+    if (manager.processReceiveAll().frames != 0 || manager.receiveRing().overruns() != 1) {
+        throw std::runtime_error("DMA lap was not detected");
+    }
+
+    dma.write(makeFrame(COMMAND_ID::Mode, {0x55}));
+    manager.processReceiveAll();
+    if (received.size() != 1 || received[0] != 0x55) {
+        throw std::runtime_error("Parsing did not restart after a DMA lap");
+    }
+}
+
+void testStatisticsCountFailures() {
+    CommandManager manager;
+    Mode mode;
+    manager[COMMAND_ID::Mode] = &mode;
+
+    std::vector<uint8_t> stream = makeFrame(COMMAND_ID::Mode, {0x01});
+    auto badChecksum = makeFrame(COMMAND_ID::Mode, {0x02});
+    badChecksum[3]++;
+    auto badStop = makeFrame(COMMAND_ID::Mode, {0x03});
+    badStop[4] = 'x';
+    const std::vector<uint8_t> badId = {'s', 0x40, 'x'};
+    const std::vector<uint8_t> noise = {'x', 'y', 'z'};
+    const auto noHandler = makeFrame(COMMAND_ID::Goal, std::vector<uint8_t>(16, 0x11));
+    const std::vector<const std::vector<uint8_t> *> parts = {&badChecksum, &badStop, &badId, &noise, &noHandler};
+    for (const auto *part : parts) {
+        stream.insert(stream.end(), part->begin(), part->end());
+    }
+    manager.receive(stream.begin(), stream.end());
+    manager.processReceiveAll();
+
+    // Valid framing and checksum, but two body bytes for Mode.
+    const auto badLength = makeFrame(COMMAND_ID::Mode, {0x04, 0x05});
+    manager.onReceiveFrame(badLength.data(), badLength.data() + badLength.size());
+
+    const LinkStatistics stats = manager.statistics();
+    if (stats[LinkCounter::BytesIn] != stream.size() || stats[LinkCounter::RingOverflow] != 0) {
+        throw std::runtime_error("Received bytes were not counted");
+    }
+    if (stats[LinkCounter::SkippedBytes] != badStop.size() + badId.size() + noise.size()) {
+        throw std::runtime_error("Skipped bytes were not counted");
+    }
+    if (stats[LinkCounter::BadChecksum] != 1 || stats[LinkCounter::BadFraming] != 1 || stats[LinkCounter::BadId] != 1 ||
+        stats[LinkCounter::BadLength] != 1 || stats[LinkCounter::NoHandler] != 1) {
+        throw std::runtime_error("Failure reasons were not counted");
+    }
+    if (stats.framesOf(COMMAND_ID::Mode) != 1 || stats.framesOf(COMMAND_ID::Goal) != 0) {
+        throw std::runtime_error("Frames per ID were not counted");
+    }
+
+    manager.resetStatistics();
+    const auto frame = makeFrame(COMMAND_ID::Mode, {0x06});
+    manager.receive(frame.begin(), frame.end());
+    manager.processReceiveAll();
+    const LinkStatistics after = manager.statistics();
+    if (after[LinkCounter::BytesIn] != frame.size() || after[LinkCounter::BadChecksum] != 0 ||
+        after[LinkCounter::SkippedBytes] != 0 || after.framesOf(COMMAND_ID::Mode) != 1) {
+        throw std::runtime_error("Statistics were not reset");
+    }
+}
+
+void testStatisticsCountRingOverflow() {
+    CommandManager manager;
+    const std::vector<uint8_t> noise(DefaultManagerConfig::rxCapacity + 3, 'x');
+    manager.receive(noise.begin(), noise.end());
+    if (manager.statistics()[LinkCounter::RingOverflow] != 3 || manager.statistics()[LinkCounter::BytesIn] != noise.size()) {
+        throw std::runtime_error("Bytes dropped by a full ring were not counted");
+    }
+
+    BasicCommandManager<DmaConfig> dmaManager;
+    FakeCircularDma dma{dmaManager.receiveRing()};
+    for (uint8_t i = 0; i < 26; i++) {
+        dma.write(makeFrame(COMMAND_ID::Mode, {i}));
+    }
+    dmaManager.processReceiveAll();
+    if (dmaManager.statistics()[LinkCounter::RingOverflow] != 130 || dmaManager.statistics()[LinkCounter::BytesIn] != 130) {
+        throw std::runtime_error("Bytes lost in a DMA lap were not counted");
+    }
+}
+
+struct NoStatisticsConfig : DefaultManagerConfig {
+    using Statistics = statistics::Null;
+};
+
+void testStatisticsCompileAway() {
+    static_assert(sizeof(BasicCommandManager<NoStatisticsConfig>) < sizeof(CommandManager),
+                  "Disabled statistics still take space");
+    BasicCommandManager<NoStatisticsConfig> manager;
+    Mode mode;
+    manager[COMMAND_ID::Mode] = &mode;
+    const auto frame = makeFrame(COMMAND_ID::Mode, {0x01});
+    manager.receive(frame.begin(), frame.end());
+    if (manager.processReceiveAll().frames != 1) {
+        throw std::runtime_error("Frame was not dispatched without statistics");
+    }
+    if (manager.statistics().framesOf(COMMAND_ID::Mode) != 0) {
+        throw std::runtime_error("Disabled statistics counted a frame");
+    }
+}
+
+void testStatisticsReadWhileParsing() {
+    CommandManager manager;
+    Mode mode;
+    manager[COMMAND_ID::Mode] = &mode;
+    const uint32_t total = 20000;
+
+    std::atomic<bool> done{false};
+    bool monotonic = true;
+    std::thread reader([&] {
+        uint32_t last = 0;
+        while (!done.load(std::memory_order_acquire)) {
+            const uint32_t frames = manager.statistics().framesOf(COMMAND_ID::Mode);
+            monotonic = monotonic && frames >= last;
+            last = frames;
+        }
+    });
+
+    const auto frame = makeFrame(COMMAND_ID::Mode, {0x01});
+    for (uint32_t i = 0; i < total; i++) {
+        manager.receive(frame.begin(), frame.end());
+        manager.processReceiveAll();
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    if (!monotonic || manager.statistics().framesOf(COMMAND_ID::Mode) != total) {
+        throw std::runtime_error("Statistics read while parsing were inconsistent");
+    }
+}
+
+using TestFunc = void (*)();
+
+const std::vector<std::pair<const char *, TestFunc>> tests = {
+    {"Process receive contiguous", testProcessReceiveContiguous},
+    {"Process receive wrapped without allocation", testProcessReceiveWrappedWithoutAllocation},
+    {"Legacy vector handler", testLegacyVectorHandler},
+    {"Reject bad checksum", testRejectBadChecksum},
+    {"Process receive all drains burst", testProcessReceiveAllDrainsBurst},
+    {"Process receive all frame budget", testProcessReceiveAllFrameBudget},
+    {"Resync across noise and wrap", testResyncAcrossNoiseAndWrap},
+    {"Transmit frame to buffer without allocation", testTransmitFrameToBufferWithoutAllocation},
+    {"Receive ring concurrent producer", testReceiveRingConcurrentProducer},
+    {"Receive drops bytes when full", testReceiveDropsBytesWhenFull},
+    {"Large ring takes USB sized chunk", testLargeRingTakesUsbSizedChunk},
+    {"COBS encoding", testCobsEncoding},
+    {"COBS round trip with zeroes", testCobsRoundTripWithZeroes},
+    {"COBS resync after corruption", testCobsResyncAfterCorruption},
+    {"Superframe round trip", testSuperframeRoundTrip},
+    {"Superframe rejects bad entry", testSuperframeRejectsBadEntry},
+    {"DMA ring parses in place", testDmaRingParsesInPlace},
+    {"DMA ring detects lap", testDmaRingDetectsLap},
+    {"Statistics count failures", testStatisticsCountFailures},
+    {"Statistics count ring overflow", testStatisticsCountRingOverflow},
+    {"Statistics compile away", testStatisticsCompileAway},
+    {"Statistics read while parsing", testStatisticsReadWhileParsing}
+};
+
+} // namespace
+
+int main() {
+    bool success = true;
+    for (const auto &test : tests) {
+        try {
+            test.second();
+            std::cout << "[PASS] " << test.first << '\n';
+        } catch (const std::exception &ex) {
+            success = false;
+            std::cerr << "[FAIL] " << test.first << ": " << ex.what() << '\n';
+        }
+    }
+
+    return success ? 0 : 1;
+}
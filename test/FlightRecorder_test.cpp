@@ -0,0 +1,249 @@
+#include "../Inc/FlightRecorder.hpp"
+#include "../Inc/CommandManager.h"
+
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "TestSupport.hpp"
+
+using namespace command;
+using namespace testsupport;
+
+namespace {
+
+int64_t fakeTime = 0;
+int64_t fakeClock() {
+    return fakeTime;
+}
+
+struct Body {
+    uint8_t data[36];
+};
+
+// Deterministic body of record i, 1 to 36 bytes long.
+FrameView bodyOf(uint64_t i, Body &body) {
+    const size_t len = 1 + i % 36;
+    for (size_t k = 0; k < len; k++) {
+        body.data[k] = static_cast<uint8_t>(i * 31 + k);
+    }
+    return FrameView(body.data, len);
+}
+
+void checkRecords(const FlightLogReader &reader, uint64_t count) {
+    uint64_t next = 0;
+    bool ok = true;
+    reader.forEachRecord([&](const flightlog::Record &record) {
+        Body expected;
+        const FrameView body = bodyOf(next, expected);
+        ok = ok && record.index == next && record.time == static_cast<int64_t>(next * 1000) &&
+             record.id == static_cast<COMMAND_ID>(next % 15) && record.body.size() == body.size() &&
+             std::memcmp(record.body.headData(), expected.data, body.size()) == 0;
+        next++;
+        return ok;
+    });
+    if (!ok || next != count) {
+        throw std::runtime_error("Recorded frames mismatch (" + std::to_string(next) + " of " + std::to_string(count) + ")");
+    }
+}
+
+void writeRecords(FlightRecorder &recorder, uint64_t count) {
+    for (uint64_t i = 0; i < count; i++) {
+        Body body;
+        fakeTime = static_cast<int64_t>(i * 1000);
+        recorder.record(static_cast<COMMAND_ID>(i % 15), bodyOf(i, body));
+    }
+}
+
+void testRecordsDispatchedFrames() {
+    const std::string path = tempPath("flight_recorder_test");
+    FlightRecorder recorder;
+    if (!recorder.open(path.c_str())) {
+        throw std::runtime_error("Recorder did not open");
+    }
+    CommandManager manager;
+    Mode mode;
+    manager[COMMAND_ID::Mode] = &mode;
+    std::vector<COMMAND_ID> forwarded;
+    recorder.attach(manager, [&forwarded](COMMAND_ID id, const FrameView &) { forwarded.push_back(id); });
+
+    std::vector<uint8_t> stream = makeFrame(COMMAND_ID::Mode, {0x11});
+    const auto noHandler = makeFrame(COMMAND_ID::Request, {0x05});
+    auto corrupted = makeFrame(COMMAND_ID::Mode, {0x22});
+    corrupted[3]++;
+    stream.insert(stream.end(), noHandler.begin(), noHandler.end());
+    stream.insert(stream.end(), corrupted.begin(), corrupted.end());
+    manager.receive(stream.begin(), stream.end());
+    manager.processReceiveAll();
+    recorder.close();
+
+    FlightLogReader reader;
+    if (!reader.open(path.c_str()) || reader.blockCount() != 1) {
+        throw std::runtime_error("Log did not open");
+    }
+    std::vector<std::pair<COMMAND_ID, uint8_t>> records;
+    reader.forEachRecord([&](const flightlog::Record &record) {
+        records.push_back({record.id, record.body[0]});
+        return true;
+    });
+    if (records != std::vector<std::pair<COMMAND_ID, uint8_t>>{{COMMAND_ID::Mode, 0x11}, {COMMAND_ID::Request, 0x05}}) {
+        throw std::runtime_error("Validated frames were not recorded exactly once");
+    }
+    if (forwarded != std::vector<COMMAND_ID>{COMMAND_ID::Mode, COMMAND_ID::Request}) {
+        throw std::runtime_error("Validated frames were not passed on");
+    }
+    unlink(path.c_str());
+}
+
+void testRecordAcrossWindowsWithoutAllocation() {
+    const std::string path = tempPath("flight_recorder_test");
+    FlightRecorder recorder;
+    recorder.setClock(&fakeClock);
+    if (!recorder.open(path.c_str(), FlightRecorder::WINDOW_ALIGN)) {
+        throw std::runtime_error("Recorder did not open");
+    }
+    // About 2 MB of records: many blocks and 30 windows.
+    const uint64_t count = 70000;
+    const size_t before = allocationCount;
+    writeRecords(recorder, count);
+    if (allocationCount != before) {
+        throw std::runtime_error("record() allocated");
+    }
+    if (recorder.frames() != count || recorder.dropped() != 0 || !recorder.close()) {
+        throw std::runtime_error("Records were dropped");
+    }
+
+    FlightLogReader reader;
+    if (!reader.open(path.c_str())) {
+        throw std::runtime_error("Log did not open");
+    }
+    checkRecords(reader, count);
+    for (size_t i = 1; i < reader.blockCount(); i++) {
+        if (reader.block(i).firstIndex <= reader.block(i - 1).firstIndex ||
+            reader.block(i).firstTime != static_cast<int64_t>(reader.block(i).firstIndex * 1000)) {
+            throw std::runtime_error("Block index mismatch");
+        }
+    }
+    unlink(path.c_str());
+}
+
+void testWindowsPreparedAhead() {
+    const std::string path = tempPath("flight_recorder_test");
+    FlightRecorder recorder;
+    recorder.setClock(&fakeClock);
+    if (!recorder.open(path.c_str(), FlightRecorder::WINDOW_ALIGN)) {
+        throw std::runtime_error("Recorder did not open");
+    }
+    // About 8 windows, each record written once the helper is ahead, like a link slower than the disk.
+    const uint64_t count = 16000;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    for (uint64_t i = 0; i < count; i++) {
+        while (!recorder.nextWindowReady()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                throw std::runtime_error("Next window was not prepared");
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        Body body;
+        fakeTime = static_cast<int64_t>(i * 1000);
+        recorder.record(static_cast<COMMAND_ID>(i % 15), bodyOf(i, body));
+    }
+    if (recorder.stalls() != 0 || recorder.frames() != count || !recorder.close()) {
+        throw std::runtime_error("record() mapped " + std::to_string(recorder.stalls()) + " windows itself");
+    }
+    FlightLogReader reader;
+    if (!reader.open(path.c_str())) {
+        throw std::runtime_error("Log did not open");
+    }
+    checkRecords(reader, count);
+    unlink(path.c_str());
+}
+
+void testSurvivesKill() {
+    const std::string path = tempPath("flight_recorder_test");
+    const uint64_t count = 5000;
+    const pid_t child = fork();
+    if (child == 0) {
+        FlightRecorder recorder;
+        recorder.setClock(&fakeClock);
+        if (recorder.open(path.c_str(), FlightRecorder::WINDOW_ALIGN)) {
+            writeRecords(recorder, count);
+        }
+        raise(SIGKILL);
+        _exit(1);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    if (!WIFSIGNALED(status)) {
+        throw std::runtime_error("Recorder process was not killed");
+    }
+
+    FlightLogReader reader;
+    if (!reader.open(path.c_str())) {
+        throw std::runtime_error("Log of a killed recorder did not open");
+    }
+    checkRecords(reader, count);
+    unlink(path.c_str());
+}
+
+void testIgnoresTornRecord() {
+    const std::string path = tempPath("flight_recorder_test");
+    {
+        FlightRecorder recorder;
+        recorder.setClock(&fakeClock);
+        recorder.open(path.c_str(), FlightRecorder::WINDOW_ALIGN);
+        writeRecords(recorder, 10);
+    }
+    // A record whose bytes were written but not committed, and a block which was never started.
+    FILE *file = std::fopen(path.c_str(), "r+b");
+    // Bodies of records 0 to 9 are 1 to 10 bytes long.
+    const size_t tail = flightlog::BLOCK_SIZE + sizeof(flightlog::BlockHeader) + 10 * flightlog::RECORD_HEADER_SIZE + 55;
+    std::fseek(file, static_cast<long>(tail), SEEK_SET);
+    const uint8_t torn[] = {0xaa, 0xbb, 0xcc, 0xdd, 0, 0, 0, 0, 5, 36, 1, 2, 3};
+    std::fwrite(torn, 1, sizeof(torn), file);
+    std::fseek(file, 3 * flightlog::BLOCK_SIZE - 1, SEEK_SET);
+    std::fputc(0, file);
+    std::fclose(file);
+
+    FlightLogReader reader;
+    if (!reader.open(path.c_str()) || reader.blockCount() != 1) {
+        throw std::runtime_error("Unstarted block was read");
+    }
+    checkRecords(reader, 10);
+    unlink(path.c_str());
+}
+
+using TestFunc = void (*)();
+
+const std::vector<std::pair<const char *, TestFunc>> tests = {
+    {"Records dispatched frames", testRecordsDispatchedFrames},
+    {"Record across windows without allocation", testRecordAcrossWindowsWithoutAllocation},
+    {"Windows prepared ahead", testWindowsPreparedAhead},
+    {"Survives kill", testSurvivesKill},
+    {"Ignores torn record", testIgnoresTornRecord}
+};
+
+} // namespace
+
+int main() {
+    bool success = true;
+    for (const auto &test : tests) {
+        try {
+            test.second();
+            std::cout << "[PASS] " << test.first << '\n';
+        } catch (const std::exception &ex) {
+            success = false;
+            std::cerr << "[FAIL] " << test.first << ": " << ex.what() << '\n';
+        }
+    }
+
+    return success ? 0 : 1;
+}
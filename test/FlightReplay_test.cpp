@@ -0,0 +1,257 @@
+#include "../Inc/FlightReplay.hpp"
+#include "../Inc/FlightRecorder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "TestSupport.hpp"
+
+using namespace command;
+using namespace testsupport;
+
+namespace {
+
+const int64_t MS = 1000000;
+
+/*
+ * Log of count records, period ns apart: Mode with the low byte of the index at even indexes,
+ * Altitude at odd ones.
+ */
+std::string writeLog(uint64_t count, int64_t period) {
+    const std::string path = tempPath("flight_replay_test");
+    FlightRecorder recorder;
+    if (!recorder.open(path.c_str(), FlightRecorder::WINDOW_ALIGN)) {
+        throw std::runtime_error("Recorder did not open");
+    }
+    std::vector<uint8_t> altitude(CommandManager::getFrameLen(COMMAND_ID::Altitude) - CommandManager::FRAME_OVERHEAD);
+    for (uint64_t i = 0; i < count; i++) {
+        const uint8_t mode = static_cast<uint8_t>(i);
+        if (i % 2 == 0) {
+            recorder.record(COMMAND_ID::Mode, FrameView(&mode, 1), static_cast<int64_t>(i) * period);
+        } else {
+            recorder.record(COMMAND_ID::Altitude, FrameView(altitude.data(), altitude.size()), static_cast<int64_t>(i) * period);
+        }
+    }
+    return path;
+}
+
+struct Receiver {
+    CommandManager manager;
+    Mode mode;
+    Altitude altitude;
+    std::vector<uint8_t> modes;
+    size_t altitudes = 0;
+
+    Receiver() {
+        modes.reserve(4096);
+        mode.setCallback([this](uint8_t value) { modes.push_back(value); });
+        altitude.setCallback([this](CommandDataType::Altitude &) { altitudes++; });
+        manager[COMMAND_ID::Mode] = &mode;
+        manager[COMMAND_ID::Altitude] = &altitude;
+    }
+};
+
+// A vehicle which answers Request and ConnectionCheck, recording what it transmits.
+struct Responder : BasicCommandManager<> {
+    Request request;
+    ConnectionCheck connectionCheck;
+    Altitude altitude;
+    std::vector<COMMAND_ID> transmitted;
+
+    Responder() {
+        (*this)[COMMAND_ID::Request] = &request;
+        (*this)[COMMAND_ID::ConnectionCheck] = &connectionCheck;
+        (*this)[COMMAND_ID::Altitude] = &altitude;
+    }
+
+    void transmit(const COMMAND_ID id) override {
+        if (id != COMMAND_ID::Last) {
+            transmitted.push_back(id);
+        }
+    }
+};
+
+void testReplayDoesNotTransmit() {
+    const std::string path = tempPath("flight_replay_test");
+    {
+        FlightRecorder recorder;
+        recorder.open(path.c_str(), FlightRecorder::WINDOW_ALIGN);
+        const uint8_t requested = static_cast<uint8_t>(COMMAND_ID::Altitude);
+        const std::vector<uint8_t> check(ConnectionCheck::getDataBodyLen(), 0x01);
+        for (int64_t i = 0; i < 10; i++) {
+            recorder.record(COMMAND_ID::Request, FrameView(&requested, 1), i * MS);
+            recorder.record(COMMAND_ID::ConnectionCheck, FrameView(check.data(), check.size()), i * MS);
+        }
+    }
+    FlightLogReader log;
+    if (!log.open(path.c_str())) {
+        throw std::runtime_error("Log did not open");
+    }
+    Responder responder;
+    FlightReplay<Responder> replay(log, responder);
+    if (replay.run() != 20 || !responder.transmitted.empty()) {
+        throw std::runtime_error("Replay transmitted " + std::to_string(responder.transmitted.size()) + " responses");
+    }
+
+    // the same frames received from the link are answered
+    std::array<uint8_t, Responder::MAX_FRAME_LEN> frame;
+    const uint8_t requested = static_cast<uint8_t>(COMMAND_ID::Altitude);
+    const size_t len = Responder::constructFrameToBuffer(COMMAND_ID::Request, FrameView(&requested, 1), frame.data(), frame.size());
+    responder.onReceiveFrame(FrameView(frame.data(), len));
+    if (responder.transmitted != std::vector<COMMAND_ID>{COMMAND_ID::Altitude}) {
+        throw std::runtime_error("Received Request was not answered");
+    }
+    unlink(path.c_str());
+}
+
+void testReplayAllWithoutAllocation() {
+    const std::string path = writeLog(3000, MS);
+    FlightLogReader log;
+    if (!log.open(path.c_str())) {
+        throw std::runtime_error("Log did not open");
+    }
+    Receiver receiver;
+    FlightReplay<> replay(log, receiver.manager);
+
+    const size_t before = allocationCount;
+    const size_t dispatched = replay.run();
+    if (allocationCount != before) {
+        throw std::runtime_error("Replay allocated");
+    }
+    if (dispatched != 3000 || receiver.modes.size() != 1500 || receiver.altitudes != 1500 || replay.position() != 3000) {
+        throw std::runtime_error("Frames were lost in replay");
+    }
+    for (size_t i = 0; i < receiver.modes.size(); i++) {
+        if (receiver.modes[i] != static_cast<uint8_t>(2 * i)) {
+            throw std::runtime_error("Replayed frames out of order");
+        }
+    }
+    unlink(path.c_str());
+}
+
+void testSeek() {
+    const std::string path = writeLog(3000, MS);
+    FlightLogReader log;
+    log.open(path.c_str());
+    Receiver receiver;
+    FlightReplay<> replay(log, receiver.manager);
+
+    if (!replay.seekIndex(2000) || replay.position() != 2000) {
+        throw std::runtime_error("Seek by index failed");
+    }
+    replay.run(10);
+    if (replay.position() != 2010 || receiver.modes.size() != 5 || receiver.modes[0] != static_cast<uint8_t>(2000)) {
+        throw std::runtime_error("Replay after seek by index mismatch");
+    }
+
+    // 1234.5 ms: the next record is 1235, and seeking back works too.
+    if (!replay.seekTime(1234 * MS + MS / 2) || replay.position() != 1235) {
+        throw std::runtime_error("Seek by time failed");
+    }
+    if (!replay.seekTime(0) || replay.position() != 0 || !replay.seekIndex(2999) || replay.position() != 2999) {
+        throw std::runtime_error("Seek to the ends failed");
+    }
+    if (replay.seekIndex(3000) || replay.seekTime(3000 * MS)) {
+        throw std::runtime_error("Seek past the end succeeded");
+    }
+    unlink(path.c_str());
+}
+
+void testFilter() {
+    const std::string path = writeLog(3000, MS);
+    FlightLogReader log;
+    log.open(path.c_str());
+    Receiver receiver;
+    FlightReplay<> replay(log, receiver.manager);
+
+    replay.setFilter({COMMAND_ID::Altitude});
+    if (replay.run() != 1500 || !receiver.modes.empty() || receiver.altitudes != 1500) {
+        throw std::runtime_error("Filter did not select Altitude");
+    }
+    replay.clearFilter();
+    replay.seekIndex(0);
+    if (replay.run(100) != 100) {
+        throw std::runtime_error("Cleared filter still applied");
+    }
+    unlink(path.c_str());
+}
+
+// Replay clock which only moves when the replay waits.
+int64_t replayNow = 0;
+std::vector<int64_t> waits;
+int64_t replayClock() {
+    return replayNow;
+}
+void replaySleep(int64_t until) {
+    waits.push_back(until);
+    replayNow = std::max(replayNow, until);
+}
+
+void testSpeed() {
+    const std::string path = writeLog(6, 10 * MS);
+    FlightLogReader log;
+    log.open(path.c_str());
+    Receiver receiver;
+    FlightReplay<> replay(log, receiver.manager);
+    replayNow = 1000 * MS;
+    waits.clear();
+    replay.setClock(&replayClock, &replaySleep);
+
+    // 50 ms recorded: 25 ms at twice the speed.
+    replay.setSpeed(2.0);
+    replay.run();
+    const std::vector<int64_t> paced = {1000 * MS, 1005 * MS, 1010 * MS, 1015 * MS, 1020 * MS, 1025 * MS};
+    if (waits != paced || receiver.modes.size() != 3) {
+        throw std::runtime_error("Replay was not paced");
+    }
+
+    replay.setSpeed(0);
+    replay.seekIndex(0);
+    waits.clear();
+    if (replay.run() != 6 || !waits.empty()) {
+        throw std::runtime_error("Replay at full speed waited");
+    }
+
+    // the default clock really waits
+    FlightReplay<> realtime(log, receiver.manager);
+    realtime.setSpeed(2.0);
+    const auto begin = std::chrono::steady_clock::now();
+    realtime.run();
+    if (std::chrono::steady_clock::now() - begin < std::chrono::milliseconds(25)) {
+        throw std::runtime_error("Replay did not wait");
+    }
+    unlink(path.c_str());
+}
+
+using TestFunc = void (*)();
+
+const std::vector<std::pair<const char *, TestFunc>> tests = {
+    {"Replay all without allocation", testReplayAllWithoutAllocation},
+    {"Replay does not transmit", testReplayDoesNotTransmit},
+    {"Seek", testSeek},
+    {"Filter", testFilter},
+    {"Speed", testSpeed}
+};
+
+} // namespace
+
+int main() {
+    bool success = true;
+    for (const auto &test : tests) {
+        try {
+            test.second();
+            std::cout << "[PASS] " << test.first << '\n';
+        } catch (const std::exception &ex) {
+            success = false;
+            std::cerr << "[FAIL] " << test.first << ": " << ex.what() << '\n';
+        }
+    }
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,247 @@
+#include "../Inc/FrameFanout.hpp"
+
+#include <arpa/inet.h>
+#include <iostream>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+#include "TestSupport.hpp"
+
+using namespace command;
+using namespace testsupport;
+
+namespace {
+
+// A local consumer: a datagram socket bound to a free loopback port or to a temporary path.
+struct Listener {
+    int fd = -1;
+    uint16_t port = 0;
+    std::string path;
+
+    explicit Listener(bool unix) {
+        fd = socket(unix ? AF_UNIX : AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            throw std::runtime_error("socket failed");
+        }
+        if (unix) {
+            static int next = 0;
+            path = "/tmp/frame_fanout_test_" + std::to_string(getpid()) + "_" + std::to_string(next++) + ".sock";
+            unlink(path.c_str());
+            sockaddr_un address = {};
+            address.sun_family = AF_UNIX;
+            path.copy(address.sun_path, path.size());
+            if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+                throw std::runtime_error("bind failed");
+            }
+        } else {
+            sockaddr_in address = {};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            socklen_t len = sizeof(address);
+            if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+                getsockname(fd, reinterpret_cast<sockaddr *>(&address), &len) != 0) {
+                throw std::runtime_error("bind failed");
+            }
+            port = ntohs(address.sin_port);
+        }
+    }
+    ~Listener() {
+        close(fd);
+        if (!path.empty()) {
+            unlink(path.c_str());
+        }
+    }
+
+    size_t subscribe(FrameFanout &fanout) const {
+        const size_t subscriber = path.empty() ? fanout.subscribeUdp(port) : fanout.subscribeUnix(path.c_str());
+        if (subscriber == FrameFanout::NO_SUBSCRIBER) {
+            throw std::runtime_error("subscribe failed");
+        }
+        return subscriber;
+    }
+
+    // Read every queued datagram.
+    std::vector<std::vector<uint8_t>> drain() const {
+        std::vector<std::vector<uint8_t>> datagrams;
+        uint8_t buffer[512];
+        ssize_t len;
+        while ((len = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT)) >= 0) {
+            datagrams.emplace_back(buffer, buffer + len);
+        }
+        return datagrams;
+    }
+};
+
+void testPublishesValidatedFrames() {
+    CommandManager manager;
+    Mode mode;
+    manager[COMMAND_ID::Mode] = &mode;
+    FrameFanout fanout;
+    size_t forwarded = 0;
+    fanout.attach(manager, [&forwarded](COMMAND_ID, const FrameView &) { forwarded++; });
+    Listener udp(false), otherUdp(false), unix(true);
+    const Listener *listeners[] = {&udp, &otherUdp, &unix};
+    for (const Listener *listener : listeners) {
+        listener->subscribe(fanout);
+    }
+
+    std::vector<std::vector<std::vector<uint8_t>>> received(3);
+    size_t allocations = 0;
+    for (size_t round = 0; round < 50; round++) {
+        // 8 frames per round, one of them corrupted, and an unregistered ID which is validated all the same
+        std::vector<uint8_t> stream;
+        for (size_t i = 0; i < 6; i++) {
+            const auto frame = makeFrame(COMMAND_ID::Mode, {static_cast<uint8_t>(round * 6 + i)});
+            stream.insert(stream.end(), frame.begin(), frame.end());
+        }
+        auto corrupted = makeFrame(COMMAND_ID::Mode, {0xff});
+        corrupted[2] ^= 1;
+        stream.insert(stream.end(), corrupted.begin(), corrupted.end());
+        const auto unregistered = makeFrame(COMMAND_ID::Request, {static_cast<uint8_t>(round)});
+        stream.insert(stream.end(), unregistered.begin(), unregistered.end());
+        manager.receive(stream.begin(), stream.end());
+
+        const size_t before = allocationCount;
+        manager.processReceiveAll();
+        fanout.flush();
+        allocations += allocationCount - before;
+        for (size_t i = 0; i < 3; i++) {
+            for (auto &datagram : listeners[i]->drain()) {
+                received[i].push_back(datagram);
+            }
+        }
+    }
+
+    if (allocations != 0) {
+        throw std::runtime_error("Publishing allocated");
+    }
+    if (forwarded != 50 * 7) {
+        throw std::runtime_error("Validated frames were not passed on");
+    }
+    for (size_t i = 0; i < 3; i++) {
+        if (received[i].size() != 50 * 7 || fanout.statistics(i).sent != 50 * 7 || fanout.statistics(i).dropped != 0) {
+            throw std::runtime_error("Subscriber " + std::to_string(i) + " received " + std::to_string(received[i].size()));
+        }
+        for (size_t round = 0; round < 50; round++) {
+            for (size_t k = 0; k < 7; k++) {
+                const std::vector<uint8_t> expected = k < 6
+                    ? std::vector<uint8_t>{static_cast<uint8_t>(COMMAND_ID::Mode), static_cast<uint8_t>(round * 6 + k)}
+                    : std::vector<uint8_t>{static_cast<uint8_t>(COMMAND_ID::Request), static_cast<uint8_t>(round)};
+                if (received[i][round * 7 + k] != expected) {
+                    throw std::runtime_error("Datagram mismatch");
+                }
+            }
+        }
+    }
+}
+
+void testBatchesWithSendmmsg() {
+    FrameFanout fanout;
+    Listener first(false), second(false);
+    first.subscribe(fanout);
+    second.subscribe(fanout);
+    uint8_t body[3] = {1, 2, 3};
+    for (size_t i = 0; i + 1 < FrameFanout::BATCH; i++) {
+        fanout.publish(COMMAND_ID::Altitude, FrameView(body, sizeof(body)));
+    }
+    if (fanout.sends() != 0 || fanout.pending() != FrameFanout::BATCH - 1 || !first.drain().empty()) {
+        throw std::runtime_error("Sent before the batch was full");
+    }
+    fanout.publish(COMMAND_ID::Altitude, FrameView(body, sizeof(body)));
+    if (fanout.sends() != 2 || fanout.pending() != 0) {
+        throw std::runtime_error("Full batch was not sent with one call per subscriber");
+    }
+    if (first.drain().size() != FrameFanout::BATCH || second.drain().size() != FrameFanout::BATCH) {
+        throw std::runtime_error("Batch was not received");
+    }
+    if (fanout.flush() != 0 || fanout.sends() != 2) {
+        throw std::runtime_error("Empty flush sent");
+    }
+}
+
+void testDropsOnSlowSubscriber() {
+    FrameFanout fanout;
+    Listener fast(false), slow(true);
+    const size_t fastSubscriber = fast.subscribe(fanout);
+    const size_t slowSubscriber = slow.subscribe(fanout);
+    uint8_t body[20] = {};
+    size_t received = 0;
+    const size_t count = 100 * FrameFanout::BATCH;
+    for (size_t i = 0; i < count; i++) {
+        body[0] = static_cast<uint8_t>(i);
+        fanout.publish(COMMAND_ID::IMU, FrameView(body, sizeof(body)));
+        if (fanout.pending() == 0) {
+            for (const auto &datagram : fast.drain()) {
+                if (datagram[1] != static_cast<uint8_t>(received++)) {
+                    throw std::runtime_error("Fast subscriber lost frames");
+                }
+            }
+        }
+    }
+
+    const FrameFanout::SubscriberStatistics fastStats = fanout.statistics(fastSubscriber);
+    const FrameFanout::SubscriberStatistics slowStats = fanout.statistics(slowSubscriber);
+    if (received != count || fastStats.sent != count || fastStats.dropped != 0) {
+        throw std::runtime_error("Fast subscriber was held back");
+    }
+    if (slowStats.dropped == 0 || slowStats.sent + slowStats.dropped != count || slow.drain().size() != slowStats.sent) {
+        throw std::runtime_error("Slow subscriber statistics mismatch");
+    }
+}
+
+void testSubscribers() {
+    FrameFanout fanout;
+    if (fanout.subscribeUnix("/tmp/frame_fanout_test_missing.sock") != FrameFanout::NO_SUBSCRIBER ||
+        fanout.subscribeUnix(std::string(200, 'x').c_str()) != FrameFanout::NO_SUBSCRIBER) {
+        throw std::runtime_error("Subscribed to nothing");
+    }
+    Listener listener(false);
+    for (size_t i = 0; i < FrameFanout::MAX_SUBSCRIBERS; i++) {
+        if (listener.subscribe(fanout) != i) {
+            throw std::runtime_error("Subscriber numbers are not dense");
+        }
+    }
+    if (fanout.subscribeUdp(listener.port) != FrameFanout::NO_SUBSCRIBER) {
+        throw std::runtime_error("Subscribed past the limit");
+    }
+    fanout.unsubscribe(3);
+    if (fanout.subscriberCount() != FrameFanout::MAX_SUBSCRIBERS - 1 || listener.subscribe(fanout) != 3) {
+        throw std::runtime_error("Unsubscribed slot was not reused");
+    }
+
+    uint8_t body[FrameFanout::MAX_DATAGRAM] = {};
+    if (fanout.publish(COMMAND_ID::Mode, FrameView(body, sizeof(body))) || fanout.rejected() != 1 || fanout.pending() != 0) {
+        throw std::runtime_error("Oversized body was published");
+    }
+}
+
+using TestFunc = void (*)();
+
+const std::vector<std::pair<const char *, TestFunc>> tests = {
+    {"Publishes validated frames", testPublishesValidatedFrames},
+    {"Batches with sendmmsg", testBatchesWithSendmmsg},
+    {"Drops on slow subscriber", testDropsOnSlowSubscriber},
+    {"Subscribers", testSubscribers}
+};
+
+} // namespace
+
+int main() {
+    bool success = true;
+    for (const auto &test : tests) {
+        try {
+            test.second();
+            std::cout << "[PASS] " << test.first << '\n';
+        } catch (const std::exception &ex) {
+            success = false;
+            std::cerr << "[FAIL] " << test.first << ": " << ex.what() << '\n';
+        }
+    }
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+#include "../Inc/CommandManager.h"
+
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace command;
+
+namespace {
+
+const uint8_t checkInput[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+template <typename Integrity>
+typename Integrity::value_type checkValue() {
+    return integrity::compute<Integrity>(FrameView(checkInput, sizeof(checkInput)));
+}
+
+void testCheckValues() {
+    if (checkValue<integrity::Sum8>() != 0xDD) {
+        throw std::runtime_error("Sum8 check value mismatch");
+    }
+    if (checkValue<integrity::Crc8>() != 0xF4) {
+        throw std::runtime_error("CRC-8 check value mismatch");
+    }
+    if (checkValue<integrity::Crc16Ccitt>() != 0x29B1) {
+        throw std::runtime_error("CRC-16/CCITT check value mismatch");
+    }
+    if (checkValue<integrity::Crc32c>() != 0xE3069283) {
+        throw std::runtime_error("CRC-32C check value mismatch");
+    }
+}
+
+void testCrc32cTableMatchesDispatch() {
+    std::array<uint8_t, 61> data;
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<uint8_t>(i * 37 + 11);
+    }
+    // Every length and alignment, so the word loops and the byte tails of both paths are compared.
+    for (size_t offset = 0; offset < 8; offset++) {
+        for (size_t len = 0; len + offset <= data.size(); len++) {
+            const uint32_t table = integrity::Crc32c::updateTable(integrity::Crc32c::init(), data.data() + offset, len);
+            const uint32_t used = integrity::Crc32c::update(integrity::Crc32c::init(), data.data() + offset, len);
+            if (table != used) {
+                throw std::runtime_error("CRC-32C hardware and table results differ");
+            }
+        }
+    }
+}
+
+void testComputeAcrossSegments() {
+    const FrameView whole(checkInput, sizeof(checkInput));
+    const FrameView split(checkInput, 4, checkInput + 4, sizeof(checkInput) - 4);
+    if (integrity::compute<integrity::Crc32c>(whole) != integrity::compute<integrity::Crc32c>(split)) {
+        throw std::runtime_error("CRC-32C of a split view differs");
+    }
+    if (integrity::compute<integrity::Crc16Ccitt>(whole) != integrity::compute<integrity::Crc16Ccitt>(split)) {
+        throw std::runtime_error("CRC-16 of a split view differs");
+    }
+}
+
+template <typename I>
+struct IntegrityConfig : DefaultManagerConfig {
+    using Integrity = I;
+};
+
+template <typename I>
+void roundTrip(const char *name) {
+    using Manager = BasicCommandManager<IntegrityConfig<I>>;
+    static_assert(Manager::getFrameLen(COMMAND_ID::Mode) == 1 + 3 + I::size, "Frame overhead must follow the check size");
+
+    Manager manager;
+    Mode mode;
+    uint8_t received = 0;
+    mode.setCallback([&](uint8_t value) { received = value; });
+    manager[COMMAND_ID::Mode] = &mode;
+
+    mode.setData(0x5A);
+    const std::vector<uint8_t> frame = manager.constructTransmitFrame(COMMAND_ID::Mode);
+    if (frame.size() != Manager::getFrameLen(COMMAND_ID::Mode)) {
+        throw std::runtime_error(std::string(name) + ": frame length mismatch");
+    }
+
+    // Wrap the frame around the end of the ring.
+    const std::vector<uint8_t> noise(DefaultManagerConfig::rxCapacity - 3, 'x');
+    manager.receive(noise.begin(), noise.end());
+    manager.processReceiveAll();
+    manager.receive(frame.begin(), frame.end());
+    if (manager.processReceive() != COMMAND_ID::Mode || received != 0x5A) {
+        throw std::runtime_error(std::string(name) + ": frame was not dispatched");
+    }
+
+    // Every single-bit error in ID, body or check must be caught.
+    for (size_t byte = 1; byte + 1 < frame.size(); byte++) {
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            std::vector<uint8_t> corrupted = frame;
+            corrupted[byte] ^= uint8_t(1) << bit;
+            if (manager.onReceiveFrame(corrupted.data(), corrupted.data() + corrupted.size()) != COMMAND_ID::Last) {
+                throw std::runtime_error(std::string(name) + ": corrupted frame was accepted");
+            }
+        }
+    }
+}
+
+void testManagerRoundTrip() {
+    roundTrip<integrity::Sum8>("Sum8");
+    roundTrip<integrity::Crc8>("CRC-8");
+    roundTrip<integrity::Crc16Ccitt>("CRC-16/CCITT");
+    roundTrip<integrity::Crc32c>("CRC-32C");
+}
+
+void testCrcCatchesSwappedBytes() {
+    // An additive sum can not see reordered bytes; a CRC can.
+    using Manager = BasicCommandManager<IntegrityConfig<integrity::Crc16Ccitt>>;
+    Manager manager;
+    Goal goal;
+    CommandDataType::Coordinates value;
+    value.latitude() = 35.5;
+    value.longitude() = 139.25;
+    goal.setData(value);
+    manager[COMMAND_ID::Goal] = &goal;
+
+    std::vector<uint8_t> frame = manager.constructTransmitFrame(COMMAND_ID::Goal);
+    std::swap(frame[8], frame[16]);
+    if (frame[8] == frame[16]) {
+        throw std::runtime_error("Test data does not change when swapped");
+    }
+    if (manager.onReceiveFrame(frame.data(), frame.data() + frame.size()) != COMMAND_ID::Last) {
+        throw std::runtime_error("Frame with swapped bytes was accepted");
+    }
+}
+
+using TestFunc = void (*)();
+
+const std::vector<std::pair<const char *, TestFunc>> tests = {
+    {"Check values", testCheckValues},
+    {"CRC-32C table matches dispatch", testCrc32cTableMatchesDispatch},
+    {"Compute across segments", testComputeAcrossSegments},
+    {"Manager round trip", testManagerRoundTrip},
+    {"CRC catches swapped bytes", testCrcCatchesSwappedBytes}
+};
+
+} // namespace
+
+int main() {
+    bool success = true;
+    for (const auto &test : tests) {
+        try {
+            test.second();
+            std::cout << "[PASS] " << test.first << '\n';
+        } catch (const std::exception &ex) {
+            success = false;
+            std::cerr << "[FAIL] " << test.first << ": " << ex.what() << '\n';
+        }
+    }
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,214 @@
+#include "../Inc/LinkReactor.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "TestSupport.hpp"
+
+using namespace command;
+using namespace testsupport;
+
+namespace {
+
+struct GroundConfig : DefaultManagerConfig {
+    static constexpr size_t rxCapacity = 1024;
+};
+using GroundManager = BasicCommandManager<GroundConfig>;
+
+// The receiving side of one CanSat: its manager and handlers.
+struct Vehicle {
+    GroundManager manager;
+    Mode mode;
+    std::vector<uint8_t> modes;
+    int fd[2] = {-1, -1}; // fd[0] is serviced by the reactor, the test writes to fd[1]
+
+    Vehicle() {
+        mode.setCallback([this](uint8_t value) { modes.push_back(value); });
+        manager[COMMAND_ID::Mode] = &mode;
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fd) != 0) {
+            throw std::runtime_error("socketpair failed");
+        }
+    }
+    ~Vehicle() {
+        for (int f : fd) {
+            if (f >= 0) {
+                close(f);
+            }
+        }
+    }
+
+    uint32_t received() const {
+        return manager.statistics().framesOf(COMMAND_ID::Mode);
+    }
+};
+
+uint8_t valueOf(size_t link, size_t i) {
+    return static_cast<uint8_t>(link * 31 + i);
+}
+
+void writeAll(int fd, const std::vector<uint8_t> &bytes) {
+    size_t pos = 0;
+    while (pos < bytes.size()) {
+        const ssize_t len = write(fd, bytes.data() + pos, bytes.size() - pos);
+        if (len <= 0) {
+            throw std::runtime_error("write failed");
+        }
+        pos += static_cast<size_t>(len);
+    }
+}
+
+template<typename F>
+void waitFor(F done) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            throw std::runtime_error("Timed out");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void checkModes(const Vehicle &vehicle, size_t link, size_t count) {
+    if (vehicle.modes.size() != count) {
+        throw std::runtime_error("Link " + std::to_string(link) + " received " + std::to_string(vehicle.modes.size()) +
+                                 " of " + std::to_string(count));
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (vehicle.modes[i] != valueOf(link, i)) {
+            throw std::runtime_error("Frames of link " + std::to_string(link) + " mixed up");
+        }
+    }
+}
+
+void testLinksOnShards() {
+    const size_t linkCount = 6;
+    const size_t count = 3000;
+    std::vector<std::unique_ptr<Vehicle>> vehicles;
+    LinkReactor<GroundManager> reactor(3);
+    for (size_t link = 0; link < linkCount; link++) {
+        vehicles.emplace_back(new Vehicle());
+        if (reactor.add(vehicles[link]->fd[0], vehicles[link]->manager) != link) {
+            throw std::runtime_error("Link was not added");
+        }
+    }
+    if (!reactor.start()) {
+        throw std::runtime_error("Reactor did not start");
+    }
+
+    // frames of every link in chunks of 1 to 47 bytes, interleaved over the links
+    std::vector<std::vector<uint8_t>> streams(linkCount);
+    for (size_t link = 0; link < linkCount; link++) {
+        for (size_t i = 0; i < count; i++) {
+            const auto frame = makeFrame(COMMAND_ID::Mode, {valueOf(link, i)});
+            streams[link].insert(streams[link].end(), frame.begin(), frame.end());
+        }
+    }
+    std::vector<size_t> pos(linkCount, 0);
+    for (size_t chunk = 1; pos[0] < streams[0].size(); chunk = chunk % 47 + 1) {
+        for (size_t link = 0; link < linkCount; link++) {
+            const size_t end = std::min(pos[link] + chunk, streams[link].size());
+            writeAll(vehicles[link]->fd[1], std::vector<uint8_t>(streams[link].begin() + pos[link], streams[link].begin() + end));
+            pos[link] = end;
+        }
+    }
+
+    waitFor([&]() {
+        for (const auto &vehicle : vehicles) {
+            if (vehicle->received() < count) {
+                return false;
+            }
+        }
+        return true;
+    });
+    reactor.stop();
+    for (size_t link = 0; link < linkCount; link++) {
+        checkModes(*vehicles[link], link, count);
+        const LinkStatistics stats = vehicles[link]->manager.statistics();
+        if (stats[LinkCounter::BytesIn] != streams[link].size() || stats[LinkCounter::SkippedBytes] != 0) {
+            throw std::runtime_error("Link statistics mismatch");
+        }
+    }
+}
+
+void testBackpressureWithoutOverflow() {
+    // far more than the 1 KiB ring, written before anything is read
+    const size_t count = 20000;
+    Vehicle vehicle;
+    LinkReactor<GroundManager> reactor;
+    reactor.add(vehicle.fd[0], vehicle.manager);
+    std::vector<uint8_t> stream;
+    for (size_t i = 0; i < count; i++) {
+        const auto frame = makeFrame(COMMAND_ID::Mode, {valueOf(0, i)});
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+    std::thread writer([&]() { writeAll(vehicle.fd[1], stream); });
+
+    size_t frames = 0;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (frames < count && std::chrono::steady_clock::now() < deadline) {
+        frames += reactor.poll(0, 100);
+    }
+    writer.join();
+    if (frames != count || vehicle.manager.statistics()[LinkCounter::RingOverflow] != 0) {
+        throw std::runtime_error("Frames were lost");
+    }
+    checkModes(vehicle, 0, count);
+}
+
+void testClosedLink() {
+    Vehicle first;
+    Vehicle second;
+    LinkReactor<GroundManager> reactor(2);
+    std::atomic<size_t> closedLink{LinkReactor<GroundManager>::NO_LINK};
+    reactor.setClosedHandler([&closedLink](size_t link) { closedLink.store(link); });
+    reactor.add(first.fd[0], first.manager);
+    reactor.add(second.fd[0], second.manager);
+    reactor.start();
+    if (reactor.add(first.fd[1], first.manager) != LinkReactor<GroundManager>::NO_LINK) {
+        throw std::runtime_error("Link was added while running");
+    }
+
+    close(second.fd[1]);
+    second.fd[1] = -1;
+    waitFor([&]() { return closedLink.load() == 1; });
+    if (reactor.isOpen(1) || !reactor.isOpen(0)) {
+        throw std::runtime_error("Wrong link closed");
+    }
+    writeAll(first.fd[1], makeFrame(COMMAND_ID::Mode, {valueOf(0, 0)}));
+    waitFor([&]() { return first.received() == 1; });
+    reactor.stop();
+    checkModes(first, 0, 1);
+}
+
+using TestFunc = void (*)();
+
+const std::vector<std::pair<const char *, TestFunc>> tests = {
+    {"Links on shards", testLinksOnShards},
+    {"Backpressure without overflow", testBackpressureWithoutOverflow},
+    {"Closed link", testClosedLink}
+};
+
+} // namespace
+
+int main() {
+    bool success = true;
+    for (const auto &test : tests) {
+        try {
+            test.second();
+            std::cout << "[PASS] " << test.first << '\n';
+        } catch (const std::exception &ex) {
+            success = false;
+            std::cerr << "[FAIL] " << test.first << ": " << ex.what() << '\n';
+        }
+    }
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,268 @@
+#include "../Inc/RequestTracker.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "TestSupport.hpp"
+
+using namespace command;
+using namespace testsupport;
+
+namespace {
+
+uint32_t fakeNow = 0;
+uint32_t fakeClock() {
+    return fakeNow;
+}
+
+// The ground station: records the IDs asked for by every Request frame it transmits.
+struct Ground : BasicCommandManager<> {
+    Request request;
+    Altitude altitude;
+    std::vector<COMMAND_ID> requested;
+
+    Ground() {
+        (*this)[COMMAND_ID::Request] = &request;
+        (*this)[COMMAND_ID::Altitude] = &altitude;
+    }
+
+    void transmit(const COMMAND_ID id) override {
+        uint8_t frame[MAX_FRAME_LEN];
+        if (id == COMMAND_ID::Request && constructTransmitFrameInto(id, frame, sizeof(frame)) > 0) {
+            requested.push_back(static_cast<COMMAND_ID>(frame[2]));
+        }
+    }
+
+    void answer(COMMAND_ID id, size_t bodyLen) {
+        const auto frame = makeFrame(id, std::vector<uint8_t>(bodyLen, 0));
+        receive(frame.begin(), frame.end());
+        processReceiveAll();
+    }
+};
+
+struct Outcomes {
+    std::vector<std::pair<COMMAND_ID, uint32_t>> answered;
+    std::vector<COMMAND_ID> timedOut;
+};
+
+template<class Tracker>
+void track(Tracker &tracker, Outcomes &outcomes) {
+    tracker.setAnsweredHandler([&outcomes](COMMAND_ID id, uint32_t us) { outcomes.answered.emplace_back(id, us); });
+    tracker.setTimeoutHandler([&outcomes](COMMAND_ID id) { outcomes.timedOut.push_back(id); });
+}
+
+template<class Tracker>
+void advance(Tracker &tracker, uint32_t us) {
+    fakeNow += us;
+    tracker.poll();
+}
+
+void testAnswered() {
+    fakeNow = 0xfffff000; // the clock wraps during the test
+    Ground ground;
+    RequestTracker<Ground> tracker(ground, ground.request, &fakeClock);
+    Outcomes outcomes;
+    track(tracker, outcomes);
+    size_t forwarded = 0;
+    tracker.attach(ground, [&forwarded](COMMAND_ID, const FrameView &) { forwarded++; });
+
+    if (!tracker.request(COMMAND_ID::Altitude, 50000) || !tracker.isOutstanding(COMMAND_ID::Altitude)) {
+        throw std::runtime_error("Request was not accepted");
+    }
+    if (ground.requested != std::vector<COMMAND_ID>{COMMAND_ID::Altitude}) {
+        throw std::runtime_error("Request frame was not sent");
+    }
+    advance(tracker, 12345);
+    ground.answer(COMMAND_ID::Altitude, Altitude::getDataBodyLen());
+    if (outcomes.answered.size() != 1 || outcomes.answered[0].first != COMMAND_ID::Altitude ||
+        outcomes.answered[0].second != 12345 || tracker.outstanding() != 0 || forwarded != 1) {
+        throw std::runtime_error("Answer was not matched");
+    }
+    advance(tracker, 100000);
+    ground.answer(COMMAND_ID::Altitude, Altitude::getDataBodyLen());
+    const RequestStatistics stats = tracker.statistics();
+    if (!outcomes.timedOut.empty() || outcomes.answered.size() != 1 || stats.answered != 1 || forwarded != 2) {
+        throw std::runtime_error("Unrequested command answered");
+    }
+    const LatencyHistogram latency = stats.latencyOf(COMMAND_ID::Altitude);
+    if (latency.count != 1 || latency.min != 12345 || latency.max != 12345 ||
+        latency.buckets[LatencyHistogram::bucketOf(12345)] != 1) {
+        throw std::runtime_error("Latency was not recorded");
+    }
+}
+
+void testNoDuplicateRequests() {
+    fakeNow = 0;
+    Ground ground;
+    RequestTracker<Ground> tracker(ground, ground.request, &fakeClock);
+    tracker.attach(ground);
+    tracker.request(COMMAND_ID::GPS, 10000);
+    if (tracker.request(COMMAND_ID::GPS, 10000) || ground.requested.size() != 1 || tracker.statistics().refused != 1) {
+        throw std::runtime_error("Outstanding request was sent again");
+    }
+    if (!tracker.request(COMMAND_ID::Mode, 10000) || tracker.outstanding() != 2 || tracker.request(COMMAND_ID::Last, 1)) {
+        throw std::runtime_error("Other IDs were not independent");
+    }
+    tracker.cancel(COMMAND_ID::GPS);
+    if (!tracker.request(COMMAND_ID::GPS, 10000) || ground.requested.size() != 3) {
+        throw std::runtime_error("Cancelled request was not sent again");
+    }
+}
+
+void testTimeout() {
+    fakeNow = 500; // in the middle of a tick
+    Ground ground;
+    RequestTracker<Ground> tracker(ground, ground.request, &fakeClock);
+    Outcomes outcomes;
+    track(tracker, outcomes);
+    tracker.attach(ground);
+    fakeNow += 300;
+    tracker.request(COMMAND_ID::GPS, 10000);
+    for (uint32_t us = 0; us + 100 < 10000; us += 100) {
+        advance(tracker, 100);
+        if (!outcomes.timedOut.empty()) {
+            throw std::runtime_error("Timed out early after " + std::to_string(us + 100) + " us");
+        }
+    }
+    advance(tracker, 1100);
+    if (outcomes.timedOut != std::vector<COMMAND_ID>{COMMAND_ID::GPS} || tracker.isOutstanding(COMMAND_ID::GPS) ||
+        tracker.statistics().timedOut != 1) {
+        throw std::runtime_error("Timeout was not reported within a tick");
+    }
+    ground.answer(COMMAND_ID::GPS, Gps::getDataBodyLen());
+    if (!outcomes.answered.empty()) {
+        throw std::runtime_error("Late answer was matched");
+    }
+}
+
+void testRetries() {
+    fakeNow = 0;
+    Ground ground;
+    RequestTracker<Ground> tracker(ground, ground.request, &fakeClock);
+    Outcomes outcomes;
+    track(tracker, outcomes);
+    tracker.attach(ground);
+    tracker.request(COMMAND_ID::IMU, 5000, 2);
+    advance(tracker, 5000);
+    advance(tracker, 5000);
+    if (ground.requested.size() != 3 || !outcomes.timedOut.empty()) {
+        throw std::runtime_error("Request was not sent again");
+    }
+    // the round trip counts from the last send
+    advance(tracker, 700);
+    ground.answer(COMMAND_ID::IMU, Imu::getDataBodyLen());
+    if (outcomes.answered.size() != 1 || outcomes.answered[0].second != 700) {
+        throw std::runtime_error("Retried request was not answered");
+    }
+
+    tracker.request(COMMAND_ID::IMU, 5000, 1);
+    for (int i = 0; i < 20; i++) {
+        advance(tracker, 1000);
+    }
+    const RequestStatistics stats = tracker.statistics();
+    if (outcomes.timedOut.size() != 1 || ground.requested.size() != 5 || stats.transmitted != 5 || stats.requested != 2) {
+        throw std::runtime_error("Retries were not bounded");
+    }
+}
+
+void testWheelLaps() {
+    fakeNow = 0;
+    Ground ground;
+    RequestTracker<Ground, 8> tracker(ground, ground.request, &fakeClock, 1000);
+    Outcomes outcomes;
+    track(tracker, outcomes);
+    // deadlines on the same slot several laps apart, and a handler which requests again
+    tracker.request(COMMAND_ID::GPS, 3000);
+    tracker.request(COMMAND_ID::IMU, 11000);
+    tracker.request(COMMAND_ID::Mode, 19000);
+    tracker.request(COMMAND_ID::Altitude, 43000);
+    tracker.setTimeoutHandler([&outcomes, &tracker](COMMAND_ID id) {
+        outcomes.timedOut.push_back(id);
+        if (id == COMMAND_ID::GPS) {
+            tracker.request(COMMAND_ID::Goal, 8000);
+        }
+    });
+
+    std::vector<std::pair<COMMAND_ID, uint32_t>> expired;
+    size_t seen = 0;
+    for (int i = 0; i < 50; i++) {
+        advance(tracker, 1000);
+        for (; seen < outcomes.timedOut.size(); seen++) {
+            expired.emplace_back(outcomes.timedOut[seen], fakeNow);
+        }
+    }
+    // the order within one tick is not specified
+    std::sort(expired.begin(), expired.end(), [](const auto &a, const auto &b) {
+        return a.second != b.second ? a.second < b.second : a.first < b.first;
+    });
+    const std::vector<std::pair<COMMAND_ID, uint32_t>> expected = {
+        {COMMAND_ID::GPS, 3000}, {COMMAND_ID::Goal, 11000}, {COMMAND_ID::IMU, 11000},
+        {COMMAND_ID::Mode, 19000}, {COMMAND_ID::Altitude, 43000}};
+    if (expired != expected || tracker.outstanding() != 0) {
+        throw std::runtime_error("Deadlines fired out of order");
+    }
+
+    // a poll long after, crossing many laps at once
+    tracker.request(COMMAND_ID::GPS, 30000);
+    advance(tracker, 100000);
+    if (outcomes.timedOut.size() != 6) {
+        throw std::runtime_error("Deadline was skipped");
+    }
+}
+
+void testHistogram() {
+    LatencyHistogram histogram;
+    if (histogram.quantile(0.5) != 0 || histogram.mean() != 0) {
+        throw std::runtime_error("Empty histogram");
+    }
+    for (uint32_t us = 1; us <= 1000; us++) {
+        histogram.add(us);
+    }
+    histogram.add(0);
+    if (histogram.count != 1001 || histogram.min != 0 || histogram.max != 1000 || histogram.mean() != 500) {
+        throw std::runtime_error("Histogram summary mismatch");
+    }
+    if (histogram.buckets[0] != 1 || histogram.buckets[1] != 1 || histogram.buckets[10] != 1000 - 511) {
+        throw std::runtime_error("Histogram buckets mismatch");
+    }
+    if (histogram.quantile(0.5) != 511 || histogram.quantile(0.99) != 1000 || histogram.quantile(0) != 0 ||
+        histogram.quantile(1) != 1000) {
+        throw std::runtime_error("Histogram quantiles mismatch");
+    }
+    LatencyHistogram large;
+    large.add(UINT32_MAX);
+    if (large.buckets[32] != 1 || large.quantile(0.5) != UINT32_MAX) {
+        throw std::runtime_error("Largest latency");
+    }
+}
+
+using TestFunc = void (*)();
+
+const std::vector<std::pair<const char *, TestFunc>> tests = {
+    {"Answered", testAnswered},
+    {"No duplicate requests", testNoDuplicateRequests},
+    {"Timeout", testTimeout},
+    {"Retries", testRetries},
+    {"Wheel laps", testWheelLaps},
+    {"Histogram", testHistogram}
+};
+
+} // namespace
+
+int main() {
+    bool success = true;
+    for (const auto &test : tests) {
+        try {
+            test.second();
+            std::cout << "[PASS] " << test.first << '\n';
+        } catch (const std::exception &ex) {
+            success = false;
+            std::cerr << "[FAIL] " << test.first << ": " << ex.what() << '\n';
+        }
+    }
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,257 @@
+#include "../Inc/SerialTransport.hpp"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace command;
+
+namespace {
+
+// One end of a pty loopback which records the Mode values it receives.
+struct Station {
+    CommandManager manager;
+    Mode mode;
+    std::vector<uint8_t> modes;
+
+    Station() {
+        mode.setCallback([this](uint8_t value) { modes.push_back(value); });
+        manager[COMMAND_ID::Mode] = &mode;
+    }
+};
+
+void openPair(SerialPort &ground, SerialPort &vehicle) {
+    if (!ground.openPty(vehicle)) {
+        throw std::runtime_error("openPty failed");
+    }
+}
+
+template<typename F>
+void pollUntil(F done, std::initializer_list<std::function<void()>> polls) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            throw std::runtime_error("Timed out");
+        }
+        for (const auto &poll : polls) {
+            poll();
+        }
+    }
+}
+
+void checkModes(const Station &station, size_t count) {
+    if (station.modes.size() != count) {
+        throw std::runtime_error("Received " + std::to_string(station.modes.size()) + " of " + std::to_string(count));
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (station.modes[i] != static_cast<uint8_t>(i)) {
+            throw std::runtime_error("Frames out of order");
+        }
+    }
+}
+
+void testPtyLoopback() {
+    SerialPort groundPort, vehiclePort;
+    openPair(groundPort, vehiclePort);
+    Station ground, vehicle;
+    SerialTransport<> groundLink(ground.manager, groundPort.fd());
+    SerialTransport<> vehicleLink(vehicle.manager, vehiclePort.fd());
+
+    const size_t count = 1000;
+    for (size_t i = 0; i < count; i++) {
+        ground.mode.setData(static_cast<uint8_t>(i));
+        if (!groundLink.send(COMMAND_ID::Mode)) {
+            throw std::runtime_error("send failed");
+        }
+        if (i % 50 == 49) {
+            groundLink.poll(0);
+            vehicleLink.poll(0);
+        }
+    }
+    pollUntil([&]() { return vehicle.modes.size() >= count; },
+              {[&]() { groundLink.poll(0); }, [&]() { vehicleLink.poll(1); }});
+    checkModes(vehicle, count);
+
+    const TransportStatistics sent = groundLink.statistics();
+    const TransportStatistics received = vehicleLink.statistics();
+    const size_t bytes = count * CommandManager::getFrameLen(COMMAND_ID::Mode);
+    if (sent.framesSent != count || sent.bytesWritten != bytes || received.bytesRead != bytes ||
+        received.framesReceived != count) {
+        throw std::runtime_error("Transport statistics mismatch");
+    }
+    if (sent.writes > count / 10 || received.latencySamples == 0 || received.latencyMaxNs == 0 ||
+        received.readRate() <= 0 || sent.writeRate() <= 0) {
+        throw std::runtime_error("Writes were not coalesced or latency was not measured");
+    }
+}
+
+void testRequestResponse() {
+    SerialPort groundPort, vehiclePort;
+    openPair(groundPort, vehiclePort);
+
+    CommandManager ground;
+    Request request(COMMAND_ID::Altitude);
+    Altitude groundAltitude;
+    int16_t received = 0;
+    groundAltitude.setCallback([&received](CommandDataType::Altitude &data) { received = data.altitude(); });
+    ground[COMMAND_ID::Request] = &request;
+    ground[COMMAND_ID::Altitude] = &groundAltitude;
+    SerialTransport<> groundLink(ground, groundPort.fd());
+
+    TransportCommandManager<> vehicle;
+    Request vehicleRequest;
+    CommandDataType::Altitude data;
+    data.altitude() = 123;
+    Altitude vehicleAltitude(data);
+    vehicle[COMMAND_ID::Request] = &vehicleRequest;
+    vehicle[COMMAND_ID::Altitude] = &vehicleAltitude;
+    SerialTransport<TransportCommandManager<>> vehicleLink(vehicle, vehiclePort.fd());
+    vehicle.setTransport(&vehicleLink);
+
+    groundLink.send(COMMAND_ID::Request);
+    pollUntil([&]() { return received == 123; }, {[&]() { groundLink.poll(1); }, [&]() { vehicleLink.poll(1); }});
+    if (vehicleLink.statistics().framesSent != 1 || vehicleLink.pending() != 0) {
+        throw std::runtime_error("Response was not sent once");
+    }
+}
+
+void testResponsesBeyondCapacity() {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds) != 0) {
+        throw std::runtime_error("socketpair failed");
+    }
+    TransportCommandManager<> vehicle;
+    Request vehicleRequest;
+    Altitude vehicleAltitude;
+    vehicle[COMMAND_ID::Request] = &vehicleRequest;
+    vehicle[COMMAND_ID::Altitude] = &vehicleAltitude;
+    SerialTransport<TransportCommandManager<>> vehicleLink(vehicle, fds[0]);
+    vehicle.setTransport(&vehicleLink);
+
+    // more Requests at once than the responses fit in the transmit buffer
+    CommandManager ground;
+    Request request(COMMAND_ID::Altitude);
+    ground[COMMAND_ID::Request] = &request;
+    const std::vector<uint8_t> frame = ground.constructTransmitFrame(COMMAND_ID::Request);
+    const size_t count = 1000;
+    std::vector<uint8_t> burst;
+    for (size_t i = 0; i < count; i++) {
+        burst.insert(burst.end(), frame.begin(), frame.end());
+    }
+    const size_t responseBytes = count * CommandManager::getFrameLen(COMMAND_ID::Altitude);
+    if (responseBytes <= 4096 || write(fds[1], burst.data(), burst.size()) != static_cast<ssize_t>(burst.size())) {
+        throw std::runtime_error("Burst was not written");
+    }
+
+    const size_t dispatched = vehicleLink.poll(1000);
+    std::vector<uint8_t> buffer(2 * responseBytes);
+    size_t received = 0;
+    for (ssize_t len; (len = read(fds[1], buffer.data(), buffer.size())) > 0;) {
+        received += static_cast<size_t>(len);
+    }
+    close(fds[0]);
+    close(fds[1]);
+    const TransportStatistics stats = vehicleLink.statistics();
+    if (dispatched != count || stats.framesSent != count || stats.framesRefused != 0 || received != responseBytes) {
+        throw std::runtime_error("Responses were lost: " + std::to_string(received) + " of " +
+                                 std::to_string(responseBytes) + " bytes");
+    }
+}
+
+void testCoalescedWrites() {
+    SerialPort groundPort, vehiclePort;
+    openPair(groundPort, vehiclePort);
+    Station ground, vehicle;
+    SerialTransport<> groundLink(ground.manager, groundPort.fd());
+    SerialTransport<> vehicleLink(vehicle.manager, vehiclePort.fd());
+
+    for (size_t i = 0; i < 100; i++) {
+        ground.mode.setData(static_cast<uint8_t>(i));
+        groundLink.send(COMMAND_ID::Mode);
+    }
+    if (groundLink.pending() != 100 * CommandManager::getFrameLen(COMMAND_ID::Mode) || groundLink.statistics().writes != 0) {
+        throw std::runtime_error("send() wrote");
+    }
+    if (!groundLink.flush() || groundLink.statistics().writes != 1) {
+        throw std::runtime_error("Queued frames were not written at once");
+    }
+    pollUntil([&]() { return vehicle.modes.size() >= 100; }, {[&]() { vehicleLink.poll(1); }});
+    checkModes(vehicle, 100);
+}
+
+void testBacklogWhenPeerIsSlow() {
+    SerialPort groundPort, vehiclePort;
+    openPair(groundPort, vehiclePort);
+    Station ground, vehicle;
+    SerialTransport<> groundLink(ground.manager, groundPort.fd());
+    SerialTransport<> vehicleLink(vehicle.manager, vehiclePort.fd());
+
+    // fill the pty until it does not take more and the transmit buffer is full too
+    size_t count = 0;
+    for (bool full = false; !full;) {
+        ground.mode.setData(static_cast<uint8_t>(count));
+        if (groundLink.send(COMMAND_ID::Mode)) {
+            count++;
+        } else {
+            full = !groundLink.flush();
+        }
+        if (count > 10000000) {
+            throw std::runtime_error("pty never filled");
+        }
+    }
+    if (groundLink.pending() == 0) {
+        throw std::runtime_error("Nothing left behind");
+    }
+    // the rest is written when the pty is writable again, without new sends
+    pollUntil([&]() { return vehicle.modes.size() >= count; },
+              {[&]() { vehicleLink.poll(0); }, [&]() { groundLink.poll(1); }});
+    if (groundLink.pending() != 0) {
+        throw std::runtime_error("Backlog was not written");
+    }
+    checkModes(vehicle, count);
+}
+
+void testClosedPeer() {
+    SerialPort groundPort, vehiclePort;
+    openPair(groundPort, vehiclePort);
+    Station ground;
+    SerialTransport<> groundLink(ground.manager, groundPort.fd());
+    vehiclePort.close();
+    pollUntil([&]() { return !groundLink.isOpen(); }, {[&]() { groundLink.poll(10); }});
+    if (groundLink.poll(0) != 0) {
+        throw std::runtime_error("Closed transport polled");
+    }
+}
+
+using TestFunc = void (*)();
+
+const std::vector<std::pair<const char *, TestFunc>> tests = {
+    {"Pty loopback", testPtyLoopback},
+    {"Request response", testRequestResponse},
+    {"Responses beyond capacity", testResponsesBeyondCapacity},
+    {"Coalesced writes", testCoalescedWrites},
+    {"Backlog when peer is slow", testBacklogWhenPeerIsSlow},
+    {"Closed peer", testClosedPeer}
+};
+
+} // namespace
+
+int main() {
+    bool success = true;
+    for (const auto &test : tests) {
+        try {
+            test.second();
+            std::cout << "[PASS] " << test.first << '\n';
+        } catch (const std::exception &ex) {
+            success = false;
+            std::cerr << "[FAIL] " << test.first << ": " << ex.what() << '\n';
+        }
+    }
+
+    return success ? 0 : 1;
+}
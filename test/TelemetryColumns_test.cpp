@@ -0,0 +1,249 @@
+#include "../Inc/TelemetryColumns.hpp"
+#include "../Inc/FlightRecorder.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "TestSupport.hpp"
+
+using namespace command;
+using namespace testsupport;
+
+namespace {
+
+template<typename T>
+void recordValue(FlightRecorder &recorder, COMMAND_ID id, const T &value, int64_t time) {
+    uint8_t body[64];
+    const uint8_t len = wire::encode(body, value);
+    recorder.record(id, FrameView(body, len), time);
+}
+
+// Exports the log written by write and opens the columns.
+template<typename F>
+void exportLog(F write, TelemetryColumns &columns, const wire::ImuFullScale &scale = wire::ImuFullScale()) {
+    const std::string logPath = tempPath("telemetry_columns_test");
+    const std::string columnsPath = tempPath("telemetry_columns_test");
+    {
+        FlightRecorder recorder;
+        if (!recorder.open(logPath.c_str(), FlightRecorder::WINDOW_ALIGN)) {
+            throw std::runtime_error("Recorder did not open");
+        }
+        write(recorder);
+    }
+    FlightLogReader log;
+    if (!log.open(logPath.c_str()) || !TelemetryColumns::write(log, columnsPath.c_str(), scale)) {
+        throw std::runtime_error("Export failed");
+    }
+    if (!columns.open(columnsPath.c_str())) {
+        throw std::runtime_error("Columns did not open");
+    }
+    unlink(logPath.c_str());
+    unlink(columnsPath.c_str());
+}
+
+template<typename T>
+const T *column(const TelemetryColumns &columns, COMMAND_ID id, const char *name, size_t expectedRows) {
+    size_t rows = 0;
+    const T *values = columns.values<T>(id, name, rows);
+    if (values == nullptr || rows != expectedRows) {
+        throw std::runtime_error(std::string("Column mismatch: ") + name);
+    }
+    return values;
+}
+
+void testExportsFields() {
+    const size_t count = 1000;
+    TelemetryColumns columns;
+    exportLog([&](FlightRecorder &recorder) {
+        for (size_t i = 0; i < count; i++) {
+            const int64_t time = static_cast<int64_t>(i) * 1000;
+            CommandDataType::Altitude altitude;
+            altitude.altitude() = static_cast<int16_t>(i);
+            altitude.pressure() = 1000.0f + i * 0.5f;
+            altitude.temperature() = -static_cast<float>(i);
+            recordValue(recorder, COMMAND_ID::Altitude, altitude, time);
+
+            CommandDataType::IMU imu;
+            imu.gyro() = {static_cast<float>(i), -static_cast<float>(i), i * 0.25f};
+            recordValue(recorder, COMMAND_ID::IMU, imu, time + 1);
+
+            CommandDataType::ServoConfig servo;
+            servo.state() = static_cast<CommandDataType::ServoState>(i % 4);
+            servo.closeCount() = static_cast<uint16_t>(i * 3);
+            recordValue(recorder, COMMAND_ID::ServoConfig_prachuteRight, servo, time + 2);
+
+            CommandDataType::SensorStatus status;
+            status.camera() = i % 2 == 1;
+            status.gps() = i % 3 == 0;
+            recordValue(recorder, COMMAND_ID::SensorStatus, status, time + 3);
+        }
+        // no table, and a body of the wrong length
+        const uint8_t mode = 1;
+        recorder.record(COMMAND_ID::Mode, FrameView(&mode, 1), 0);
+        recorder.record(COMMAND_ID::Altitude, FrameView(&mode, 1), 0);
+    }, columns);
+
+    if (columns.header().skipped != 2) {
+        throw std::runtime_error("Skipped records mismatch");
+    }
+    const int64_t *time = column<int64_t>(columns, COMMAND_ID::Altitude, "time", count);
+    const int16_t *altitude = column<int16_t>(columns, COMMAND_ID::Altitude, "altitude", count);
+    const float *pressure = column<float>(columns, COMMAND_ID::Altitude, "pressure", count);
+    const float *temperature = column<float>(columns, COMMAND_ID::Altitude, "temperature", count);
+    const int64_t *imuTime = column<int64_t>(columns, COMMAND_ID::IMU, "time", count);
+    const float *gyroY = column<float>(columns, COMMAND_ID::IMU, "gyro.y", count);
+    const float *gyroZ = column<float>(columns, COMMAND_ID::IMU, "gyro.z", count);
+    const float *accelX = column<float>(columns, COMMAND_ID::IMU, "accel.x", count);
+    const int32_t *state = column<int32_t>(columns, COMMAND_ID::ServoConfig_prachuteRight, "state", count);
+    const uint16_t *closeCount = column<uint16_t>(columns, COMMAND_ID::ServoConfig_prachuteRight, "closeCount", count);
+    const bool *camera = column<bool>(columns, COMMAND_ID::SensorStatus, "camera", count);
+    const bool *gps = column<bool>(columns, COMMAND_ID::SensorStatus, "gps", count);
+    const bool *tof = column<bool>(columns, COMMAND_ID::SensorStatus, "tof", count);
+    for (size_t i = 0; i < count; i++) {
+        if (time[i] != static_cast<int64_t>(i) * 1000 || imuTime[i] != time[i] + 1 || altitude[i] != static_cast<int16_t>(i) ||
+            pressure[i] != 1000.0f + i * 0.5f || temperature[i] != -static_cast<float>(i) ||
+            gyroY[i] != -static_cast<float>(i) || gyroZ[i] != i * 0.25f || accelX[i] != 0.0f ||
+            state[i] != static_cast<int32_t>(i % 4) || closeCount[i] != static_cast<uint16_t>(i * 3) ||
+            camera[i] != (i % 2 == 1) || gps[i] != (i % 3 == 0) || tof[i]) {
+            throw std::runtime_error("Column values mismatch at row " + std::to_string(i));
+        }
+    }
+    column<int64_t>(columns, COMMAND_ID::Goal, "time", 0);
+}
+
+void testMatchesSchemaDecode() {
+    const size_t count = 777;
+    wire::ImuFullScale scale;
+    scale.gyro = 500.0f;
+    std::vector<std::vector<uint8_t>> relative;
+    std::vector<std::vector<uint8_t>> absolute;
+    std::vector<std::vector<uint8_t>> compact;
+    uint32_t seed = 12345;
+    const auto random = [&](size_t len) {
+        std::vector<uint8_t> body(len);
+        for (auto &b : body) {
+            seed = seed * 1103515245 + 12345;
+            b = static_cast<uint8_t>(seed >> 16);
+        }
+        return body;
+    };
+    TelemetryColumns columns;
+    exportLog([&](FlightRecorder &recorder) {
+        for (size_t i = 0; i < count; i++) {
+            relative.push_back(random(wire::Schema<CommandDataType::RelativeNavigation>::Format::size));
+            absolute.push_back(random(wire::Schema<CommandDataType::AbsoluteNavigation>::Format::size));
+            compact.push_back(random(wire::CompactImu::Format::size));
+            recorder.record(COMMAND_ID::RelativeNavigationLog, FrameView(relative.back().data(), relative.back().size()), 0);
+            recorder.record(COMMAND_ID::AbsoluteNavigationLog, FrameView(absolute.back().data(), absolute.back().size()), 0);
+            recorder.record(COMMAND_ID::ImuCompact, FrameView(compact.back().data(), compact.back().size()), 0);
+        }
+    }, columns, scale);
+
+    const int32_t *north = column<int32_t>(columns, COMMAND_ID::RelativeNavigationLog, "relativePositionNorth", count);
+    const int8_t *right = column<int8_t>(columns, COMMAND_ID::RelativeNavigationLog, "rightMotorPower", count);
+    const bool *onCamera = column<bool>(columns, COMMAND_ID::RelativeNavigationLog, "isDetectedGoalOnCamera", count);
+    const bool *onTof = column<bool>(columns, COMMAND_ID::RelativeNavigationLog, "isDetectedGoalOnTof", count);
+    const int16_t *distance = column<int16_t>(columns, COMMAND_ID::RelativeNavigationLog, "tofDistance", count);
+    const int16_t *goal = column<int16_t>(columns, COMMAND_ID::RelativeNavigationLog, "goalDirection", count);
+    const int32_t *east = column<int32_t>(columns, COMMAND_ID::AbsoluteNavigationLog, "relativePositionEast", count);
+    const float *gyroZ = column<float>(columns, COMMAND_ID::ImuCompact, "gyro.z", count);
+    const float *magnetX = column<float>(columns, COMMAND_ID::ImuCompact, "magnet.x", count);
+    for (size_t i = 0; i < count; i++) {
+        CommandDataType::RelativeNavigation r;
+        wire::decode(FrameView(relative[i].data(), relative[i].size()), r);
+        CommandDataType::AbsoluteNavigation a;
+        wire::decode(FrameView(absolute[i].data(), absolute[i].size()), a);
+        CommandDataType::IMU imu;
+        wire::CompactImu::Format::decode(FrameView(compact[i].data(), compact[i].size()), wire::CompactImu::tie(imu, scale));
+        if (north[i] != r.relativePositionNorth() || right[i] != r.rightMotorPower() ||
+            onCamera[i] != r.isDetectedGoalOnCamera() || onTof[i] != r.isDetectedGoalOnTof() ||
+            distance[i] != r.tofDistance() || goal[i] != r.goalDirection() || east[i] != a.relativePositionEast() ||
+            std::memcmp(&gyroZ[i], &imu.gyro()[2], sizeof(float)) != 0 ||
+            std::memcmp(&magnetX[i], &imu.magnet()[0], sizeof(float)) != 0) {
+            throw std::runtime_error("Columns differ from the schema decode at row " + std::to_string(i));
+        }
+    }
+}
+
+void testLayout() {
+    TelemetryColumns columns;
+    exportLog([](FlightRecorder &recorder) {
+        recordValue(recorder, COMMAND_ID::IMU, CommandDataType::IMU(), 0);
+    }, columns);
+
+    const columnar::TableEntry *imu = columns.find(COMMAND_ID::IMU);
+    if (imu == nullptr || std::string(imu->name) != "IMU" || imu->rows != 1 || columns.find(COMMAND_ID::Mode) != nullptr) {
+        throw std::runtime_error("Tables mismatch");
+    }
+    const std::vector<std::string> expected = {"time", "accel.x", "accel.y", "accel.z", "gyro.x", "gyro.y", "gyro.z",
+                                               "magnet.x", "magnet.y", "magnet.z"};
+    std::vector<std::string> names;
+    for (size_t i = imu->firstColumn; i < imu->firstColumn + imu->columnCount; i++) {
+        names.push_back(columns.column(i).name);
+    }
+    if (names != expected) {
+        throw std::runtime_error("IMU column names mismatch");
+    }
+    for (size_t i = 0; i < columns.header().columnCount; i++) {
+        if (columns.column(i).offset % columnar::COLUMN_ALIGN != 0) {
+            throw std::runtime_error("Column not aligned");
+        }
+    }
+    const columnar::ColumnEntry *state = columns.find(*columns.find(COMMAND_ID::ServoConfig_stabilizer), "state");
+    if (state == nullptr || state->type != columnar::Type::Int32) {
+        throw std::runtime_error("Enum column type mismatch");
+    }
+    size_t rows = 1;
+    if (columns.values<int16_t>(COMMAND_ID::IMU, "gyro.z", rows) != nullptr || rows != 0 ||
+        columns.values<float>(COMMAND_ID::IMU, "gyro.q", rows) != nullptr) {
+        throw std::runtime_error("Column of another type or name was returned");
+    }
+}
+
+void testRejectsInvalidFile() {
+    const std::string path = tempPath("telemetry_columns_test");
+    FILE *file = std::fopen(path.c_str(), "wb");
+    columnar::FileHeader header = {};
+    header.magic = columnar::FILE_MAGIC;
+    header.version = columnar::VERSION;
+    header.tableCount = 3;
+    std::fwrite(&header, sizeof(header), 1, file);
+    std::fclose(file);
+
+    TelemetryColumns columns;
+    if (columns.open(path.c_str()) || columns.isOpen()) {
+        throw std::runtime_error("Truncated file was opened");
+    }
+    unlink(path.c_str());
+}
+
+using TestFunc = void (*)();
+
+const std::vector<std::pair<const char *, TestFunc>> tests = {
+    {"Exports fields", testExportsFields},
+    {"Matches schema decode", testMatchesSchemaDecode},
+    {"Layout", testLayout},
+    {"Rejects invalid file", testRejectsInvalidFile}
+};
+
+} // namespace
+
+int main() {
+    bool success = true;
+    for (const auto &test : tests) {
+        try {
+            test.second();
+            std::cout << "[PASS] " << test.first << '\n';
+        } catch (const std::exception &ex) {
+            success = false;
+            std::cerr << "[FAIL] " << test.first << ": " << ex.what() << '\n';
+        }
+    }
+
+    return success ? 0 : 1;
+}
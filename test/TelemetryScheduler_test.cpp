@@ -0,0 +1,146 @@
+#include "../Inc/TelemetryScheduler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+using namespace command;
+
+namespace {
+
+class RecordingManager : public BasicCommandManager<> {
+public:
+    std::vector<COMMAND_ID> sent;
+
+    void transmit(const COMMAND_ID id) override {
+        sent.push_back(id);
+    }
+};
+
+void testPeriodAndPhase() {
+    RecordingManager manager;
+    TelemetryScheduler<RecordingManager> scheduler(manager);
+    scheduler.setRate(COMMAND_ID::IMU, 2, 0);
+    scheduler.setRate(COMMAND_ID::GPS, 5, 3);
+
+    std::vector<std::vector<COMMAND_ID>> ticks;
+    for (int i = 0; i < 10; i++) {
+        manager.sent.clear();
+        scheduler.tick();
+        ticks.push_back(manager.sent);
+    }
+    for (int i = 0; i < 10; i++) {
+        const bool imu = i % 2 == 0;
+        const bool gps = i % 5 == 3;
+        if (ticks[i].size() != static_cast<size_t>(imu + gps)) {
+            throw std::runtime_error("Wrong number of commands at a tick");
+        }
+        if (imu && std::find(ticks[i].begin(), ticks[i].end(), COMMAND_ID::IMU) == ticks[i].end()) {
+            throw std::runtime_error("IMU was not sent at its period");
+        }
+        if (gps && std::find(ticks[i].begin(), ticks[i].end(), COMMAND_ID::GPS) == ticks[i].end()) {
+            throw std::runtime_error("GPS was not sent at its phase");
+        }
+    }
+
+    scheduler.disable(COMMAND_ID::IMU);
+    manager.sent.clear();
+    for (int i = 0; i < 10; i++) {
+        scheduler.tick();
+    }
+    if (manager.sent.size() != 2) {
+        throw std::runtime_error("Disabled command was still sent");
+    }
+}
+
+void testAutomaticPhaseSpreadsBursts() {
+    RecordingManager manager;
+    TelemetryScheduler<RecordingManager> scheduler(manager);
+    scheduler.setRate(COMMAND_ID::IMU, 4);
+    scheduler.setRate(COMMAND_ID::Altitude, 4);
+    scheduler.setRate(COMMAND_ID::AbsoluteNavigationLog, 4);
+    scheduler.setRate(COMMAND_ID::GPS, 8);
+    scheduler.setRate(COMMAND_ID::SensorStatus, 8);
+
+    // Four ticks per period and five commands: at most two commands share a tick, never IMU and another 4-tick one.
+    for (int i = 0; i < 16; i++) {
+        manager.sent.clear();
+        if (scheduler.tick() > 1) {
+            for (auto id : manager.sent) {
+                if (id == COMMAND_ID::IMU) {
+                    throw std::runtime_error("IMU shares a tick although a free phase was available");
+                }
+            }
+        }
+        if (manager.sent.size() > 2) {
+            throw std::runtime_error("Commands lined up in one tick");
+        }
+    }
+}
+
+void testAutomaticPhaseWhileTicking() {
+    RecordingManager manager;
+    TelemetryScheduler<RecordingManager> scheduler(manager);
+    scheduler.setRate(COMMAND_ID::IMU, 2);
+    scheduler.tick();
+    // IMU is now due at odd ticks from here, although it was set with phase 0
+    scheduler.setRate(COMMAND_ID::GPS, 4);
+    for (int i = 0; i < 16; i++) {
+        manager.sent.clear();
+        if (scheduler.tick() > 1) {
+            throw std::runtime_error("Rate set at runtime collides");
+        }
+    }
+}
+
+constexpr std::array<TelemetryRate, 3> flightRates = {{
+    {COMMAND_ID::IMU, 20, 0},      // 50 Hz at 1 kHz ticks
+    {COMMAND_ID::Altitude, 100, 5},
+    {COMMAND_ID::GPS, 1000, 10},
+}};
+
+// (40 * 50 + 14 * 10 + 21 * 1) bytes/s * 10 bits
+static_assert(requiredBitrate<CommandManager>(flightRates, 1000) == 21610, "Link budget calculation changed");
+static_assert(requiredBitrate<CommandManager>(flightRates, 1000) <= 57600, "Flight telemetry does not fit the radio");
+
+void testLinkBudget() {
+    RecordingManager manager;
+    TelemetryScheduler<RecordingManager> scheduler(manager);
+    for (const auto &rate : flightRates) {
+        scheduler.setRate(rate);
+    }
+    if (scheduler.requiredBitrate(1000) != 21610) {
+        throw std::runtime_error("Runtime link budget differs from the compile-time one");
+    }
+    if (!scheduler.fitsLink(1000, 57600) || scheduler.fitsLink(1000, 19200)) {
+        throw std::runtime_error("Link budget check mismatch");
+    }
+}
+
+using TestFunc = void (*)();
+
+const std::vector<std::pair<const char *, TestFunc>> tests = {
+    {"Period and phase", testPeriodAndPhase},
+    {"Automatic phase spreads bursts", testAutomaticPhaseSpreadsBursts},
+    {"Automatic phase while ticking", testAutomaticPhaseWhileTicking},
+    {"Link budget", testLinkBudget}
+};
+
+} // namespace
+
+int main() {
+    bool success = true;
+    for (const auto &test : tests) {
+        try {
+            test.second();
+            std::cout << "[PASS] " << test.first << '\n';
+        } catch (const std::exception &ex) {
+            success = false;
+            std::cerr << "[FAIL] " << test.first << ": " << ex.what() << '\n';
+        }
+    }
+
+    return success ? 0 : 1;
+}
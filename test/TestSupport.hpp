@@ -0,0 +1,73 @@
+#ifndef COMMAND_TEST_TESTSUPPORT_HPP_
+#define COMMAND_TEST_TESTSUPPORT_HPP_
+
+/*
+ * Helpers shared by the tests. Every test is one executable built from one test file, which includes this
+ * header once: it also replaces the global operator new to count allocations.
+ */
+
+#include "../Inc/CommandHandlerBase.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace testsupport {
+
+// Allocations through operator new so far.
+inline size_t allocationCount = 0;
+
+// Wire frame of the default configuration: start byte, ID, body, Sum8, stop byte.
+inline std::vector<uint8_t> makeFrame(command::COMMAND_ID id, const std::vector<uint8_t> &body) {
+    std::vector<uint8_t> frame;
+    frame.push_back('s');
+    frame.push_back(static_cast<uint8_t>(id));
+    uint8_t sum = static_cast<uint8_t>(id);
+    for (auto b : body) {
+        frame.push_back(b);
+        sum += b;
+    }
+    frame.push_back(sum);
+    frame.push_back('e');
+    return frame;
+}
+
+// New empty file /tmp/<name>_XXXXXX.
+inline std::string tempPath(const std::string &name) {
+    std::string path = "/tmp/" + name + "_XXXXXX";
+    const int fd = mkstemp(&path[0]);
+    if (fd < 0) {
+        throw std::runtime_error("mkstemp failed");
+    }
+    close(fd);
+    return path;
+}
+
+} // namespace testsupport
+
+// GCC inlines these into the callers and takes free() of memory from operator new for a mismatch.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void *operator new(size_t size) {
+    testsupport::allocationCount++;
+    if (void *p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+#endif /* COMMAND_TEST_TESTSUPPORT_HPP_ */
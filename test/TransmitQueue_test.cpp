@@ -0,0 +1,240 @@
+#include "../Inc/TransmitQueue.hpp"
+#include "../Inc/TelemetryScheduler.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace command;
+
+namespace {
+
+/*
+ * Records started transfers; the test completes them like the DMA interrupt would.
+ */
+struct FakeDma {
+    std::vector<std::vector<uint8_t>> frames;
+    bool accept = true;
+
+    bool start(const uint8_t *data, size_t len) {
+        if (!accept) {
+            return false;
+        }
+        frames.emplace_back(data, data + len);
+        return true;
+    }
+
+    COMMAND_ID id(size_t i) const {
+        return static_cast<COMMAND_ID>(frames.at(i).at(1));
+    }
+};
+
+struct Handlers {
+    Mode mode;
+    Imu imu;
+    Gps gps;
+    Altitude altitude;
+
+    explicit Handlers(CommandManager &manager) {
+        manager[COMMAND_ID::Mode] = &mode;
+        manager[COMMAND_ID::IMU] = &imu;
+        manager[COMMAND_ID::GPS] = &gps;
+        manager[COMMAND_ID::Altitude] = &altitude;
+    }
+};
+
+void testControlOvertakesTelemetry() {
+    CommandManager manager;
+    Handlers handlers(manager);
+    FakeDma dma;
+    TransmitQueue<CommandManager> queue(manager, Callback<bool(const uint8_t *, size_t)>::bind<&FakeDma::start>(dma));
+
+    // IMU goes on the wire, GPS is staged in the second buffer and Altitude waits.
+    queue.push(COMMAND_ID::IMU, TransmitPriority::Telemetry);
+    queue.push(COMMAND_ID::GPS, TransmitPriority::Telemetry);
+    queue.push(COMMAND_ID::Altitude, TransmitPriority::Telemetry);
+    queue.push(COMMAND_ID::Mode, TransmitPriority::Control);
+    if (dma.frames.size() != 1 || dma.id(0) != COMMAND_ID::IMU) {
+        throw std::runtime_error("First frame was not started at once");
+    }
+
+    for (int i = 0; i < 3; i++) {
+        queue.onTransferComplete();
+        queue.poll();
+    }
+    queue.onTransferComplete();
+    const std::vector<COMMAND_ID> expected = {COMMAND_ID::IMU, COMMAND_ID::Mode, COMMAND_ID::GPS, COMMAND_ID::Altitude};
+    if (dma.frames.size() != expected.size()) {
+        throw std::runtime_error("Frame count mismatch");
+    }
+    for (size_t i = 0; i < expected.size(); i++) {
+        if (dma.id(i) != expected[i]) {
+            throw std::runtime_error("Control frame waited behind telemetry");
+        }
+    }
+    if (!queue.idle()) {
+        throw std::runtime_error("Queue is not idle after draining");
+    }
+}
+
+void testNextFrameStartsFromCompletion() {
+    CommandManager manager;
+    Handlers handlers(manager);
+    FakeDma dma;
+    TransmitQueue<CommandManager> queue(manager, Callback<bool(const uint8_t *, size_t)>::bind<&FakeDma::start>(dma));
+
+    queue.push(COMMAND_ID::IMU, TransmitPriority::Telemetry);
+    queue.push(COMMAND_ID::GPS, TransmitPriority::Telemetry);
+    // The staged frame is started by the completion alone, without the main loop.
+    queue.onTransferComplete();
+    if (dma.frames.size() != 2 || dma.id(1) != COMMAND_ID::GPS) {
+        throw std::runtime_error("Staged frame was not started from the completion");
+    }
+    if (dma.frames[1].size() != CommandManager::getFrameLen(COMMAND_ID::GPS)) {
+        throw std::runtime_error("Staged frame length mismatch");
+    }
+}
+
+void testQueuedTwiceIsSentOnce() {
+    CommandManager manager;
+    Handlers handlers(manager);
+    FakeDma dma;
+    TransmitQueue<CommandManager> queue(manager, Callback<bool(const uint8_t *, size_t)>::bind<&FakeDma::start>(dma));
+
+    queue.push(COMMAND_ID::IMU, TransmitPriority::Telemetry);
+    queue.push(COMMAND_ID::GPS, TransmitPriority::Telemetry);
+    for (int i = 0; i < 5; i++) {
+        queue.push(COMMAND_ID::Altitude, TransmitPriority::Telemetry);
+    }
+    while (!queue.idle()) {
+        queue.onTransferComplete();
+        queue.poll();
+    }
+    if (dma.frames.size() != 3) {
+        throw std::runtime_error("Repeated command was sent more than once");
+    }
+}
+
+void testRetryWhenTransferRefused() {
+    CommandManager manager;
+    Handlers handlers(manager);
+    FakeDma dma;
+    TransmitQueue<CommandManager> queue(manager, Callback<bool(const uint8_t *, size_t)>::bind<&FakeDma::start>(dma));
+
+    dma.accept = false;
+    queue.push(COMMAND_ID::Mode, TransmitPriority::Control);
+    if (queue.busy()) {
+        throw std::runtime_error("Refused transfer left the queue busy");
+    }
+    dma.accept = true;
+    queue.poll();
+    if (dma.frames.size() != 1 || dma.id(0) != COMMAND_ID::Mode) {
+        throw std::runtime_error("Refused frame was not retried");
+    }
+}
+
+void testSchedulerSendsThroughQueue() {
+    CommandManager manager;
+    Handlers handlers(manager);
+    FakeDma dma;
+    using Queue = TransmitQueue<CommandManager>;
+    Queue queue(manager, Callback<bool(const uint8_t *, size_t)>::bind<&FakeDma::start>(dma));
+    TelemetryScheduler<Queue> scheduler(queue);
+    scheduler.setRate(COMMAND_ID::IMU, 1, 0);
+
+    for (int i = 0; i < 4; i++) {
+        scheduler.tick();
+        queue.onTransferComplete();
+    }
+    if (dma.frames.size() != 4) {
+        throw std::runtime_error("Scheduled telemetry was not sent through the queue");
+    }
+}
+
+/*
+ * The DMA interrupt runs on its own thread and completes transfers while the main loop keeps pushing.
+ */
+struct ThreadedDma {
+    std::atomic<const uint8_t *> data{nullptr};
+    std::atomic<size_t> len{0};
+
+    bool start(const uint8_t *frame, size_t frameLen) {
+        len.store(frameLen, std::memory_order_relaxed);
+        data.store(frame, std::memory_order_release);
+        return true;
+    }
+};
+
+void testConcurrentCompletion() {
+    CommandManager manager;
+    Handlers handlers(manager);
+    ThreadedDma dma;
+    TransmitQueue<CommandManager> queue(manager, Callback<bool(const uint8_t *, size_t)>::bind<&ThreadedDma::start>(dma));
+
+    std::atomic<bool> done{false};
+    std::atomic<int> sent{0};
+    std::atomic<bool> intact{true};
+    std::thread interrupt([&] {
+        while (!done.load(std::memory_order_acquire) || dma.data.load(std::memory_order_acquire) != nullptr) {
+            const uint8_t *frame = dma.data.exchange(nullptr, std::memory_order_acq_rel);
+            if (frame == nullptr) {
+                continue;
+            }
+            const size_t len = dma.len.load(std::memory_order_relaxed);
+            const COMMAND_ID id = static_cast<COMMAND_ID>(frame[1]);
+            if (frame[0] != 's' || frame[len - 1] != 'e' || len != CommandManager::getFrameLen(id)) {
+                intact.store(false);
+            }
+            sent.fetch_add(1);
+            queue.onTransferComplete();
+        }
+    });
+
+    const COMMAND_ID ids[] = {COMMAND_ID::IMU, COMMAND_ID::GPS, COMMAND_ID::Altitude, COMMAND_ID::Mode};
+    for (int i = 0; i < 20000; i++) {
+        const COMMAND_ID id = ids[i % 4];
+        queue.push(id, id == COMMAND_ID::Mode ? TransmitPriority::Control : TransmitPriority::Telemetry);
+    }
+    while (!queue.idle()) {
+        queue.poll();
+    }
+    done.store(true, std::memory_order_release);
+    interrupt.join();
+
+    if (!intact.load()) {
+        throw std::runtime_error("Frame was modified while it was on the wire");
+    }
+    if (sent.load() == 0) {
+        throw std::runtime_error("Nothing was sent");
+    }
+}
+
+using TestFunc = void (*)();
+
+const std::vector<std::pair<const char *, TestFunc>> tests = {
+    {"Control overtakes telemetry", testControlOvertakesTelemetry},
+    {"Next frame starts from completion", testNextFrameStartsFromCompletion},
+    {"Queued twice is sent once", testQueuedTwiceIsSentOnce},
+    {"Retry when transfer refused", testRetryWhenTransferRefused},
+    {"Scheduler sends through queue", testSchedulerSendsThroughQueue},
+    {"Concurrent completion", testConcurrentCompletion}
+};
+
+} // namespace
+
+int main() {
+    bool success = true;
+    for (const auto &test : tests) {
+        try {
+            test.second();
+            std::cout << "[PASS] " << test.first << '\n';
+        } catch (const std::exception &ex) {
+            success = false;
+            std::cerr << "[FAIL] " << test.first << ": " << ex.what() << '\n';
+        }
+    }
+
+    return success ? 0 : 1;
+}